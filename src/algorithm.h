@@ -4,6 +4,18 @@
 #include <type_traits>
 #include <iterator>
 #include <cctype>
+#include <string_view>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
 
 namespace kab_advent {
 	template<typename RangeT, typename PredicateT, 
@@ -264,6 +276,18 @@ namespace kab_advent {
 		return left_trim( s, [] ( char const c ) -> bool { return std::isspace( c );} );
 	}
 
+	template<typename PredicateT>
+	auto right_trim( std::string_view s, PredicateT p ) -> std::string_view {
+		while ( !s.empty() && p( s.back() ) ) {
+			s.remove_suffix( 1 );
+		}
+		return s;
+	}
+
+	inline auto right_trim( std::string_view s ) -> std::string_view {
+		return right_trim( s, [] ( char const c ) -> bool { return std::isspace( c );} );
+	}
+
 	inline auto begins_with( std::string_view s, std::string_view v ) -> bool {
 		return s.compare( 0, v.size(), v ) == 0;
 	}
@@ -301,4 +325,431 @@ namespace kab_advent {
         }
         throw std::runtime_error("Invalid char");
     }
+    // Hash for std::string and std::string_view keys that also accepts the other type, for lookups without a conversion
+    struct string_hash {
+        using is_transparent = void;
+
+        auto operator()(std::string_view const s) const noexcept -> std::size_t {
+            return std::hash<std::string_view>()(s);
+        }
+    };
+
+    template<typename Key>
+    struct default_hash {
+        using type = std::hash<Key>;
+    };
+
+    template<>
+    struct default_hash<std::string> {
+        using type = string_hash;
+    };
+
+    template<>
+    struct default_hash<std::string_view> {
+        using type = string_hash;
+    };
+
+    // A 64-bit hash of a whole buffer, stable across runs and platforms of the same byte order, for keying files
+    // by their contents. Eight bytes per step, each folded in with the multiply and shifts of a 64-bit finalizer
+    inline auto hash_bytes(std::string_view const bytes) noexcept -> std::uint64_t {
+        auto h = std::uint64_t{0x9E3779B97F4A7C15ull} ^ bytes.size();
+        auto const mix = [&h] (std::uint64_t const word) {
+            h ^= word;
+            h *= 0xFF51AFD7ED558CCDull;
+            h ^= h >> 32;
+        };
+
+        auto i = std::size_t{0};
+        for(; i + sizeof(std::uint64_t) <= bytes.size(); i += sizeof(std::uint64_t)) {
+            auto word = std::uint64_t{0};
+            std::memcpy(&word, bytes.data() + i, sizeof(word));
+            mix(word);
+        }
+        if(i < bytes.size()) {
+            auto word = std::uint64_t{0};
+            std::memcpy(&word, bytes.data() + i, bytes.size() - i);
+            mix(word);
+        }
+
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    namespace detail {
+        // Spreads every bit of the hash into the low bits used to index a power-of-two table, since std::hash
+        // of an integer is usually the identity
+        inline auto mix_hash(std::size_t const h) noexcept -> std::size_t {
+            auto x = static_cast<std::uint64_t>(h);
+            x ^= x >> 33;
+            x *= 0xFF51AFD7ED558CCDull;
+            x ^= x >> 33;
+            return static_cast<std::size_t>(x);
+        }
+
+        struct identity_key {
+            template<typename T>
+            auto operator()(T const& value) const noexcept -> T const& {
+                return value;
+            }
+        };
+
+        struct first_key {
+            template<typename T>
+            auto operator()(T const& value) const noexcept -> decltype(value.first) const& {
+                return value.first;
+            }
+        };
+
+        // Open-addressing hash table with linear probing and backward-shift erasure. Values live in one flat array
+        // of slots, kept inline in the table until it outgrows InlineSlots, so small tables never allocate
+        template<typename Value, typename KeyOf, typename Hash, typename KeyEqual, std::size_t InlineSlots, typename Allocator>
+        class flat_hash_table {
+            static_assert(InlineSlots > 1 && (InlineSlots & (InlineSlots - 1)) == 0, "Inline capacity must be a power of two");
+
+            using slot_type = std::optional<Value>;
+            using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<slot_type>;
+
+        public:
+            using key_type = std::decay_t<decltype(KeyOf()(std::declval<Value const&>()))>;
+            using value_type = Value;
+            using size_type = std::size_t;
+            using hasher = Hash;
+            using key_equal = KeyEqual;
+            using allocator_type = Allocator;
+
+            template<typename SlotT, typename ValueT>
+            class basic_iterator {
+            public:
+                using value_type = std::remove_const_t<ValueT>;
+                using difference_type = std::ptrdiff_t;
+                using reference = ValueT &;
+                using pointer = ValueT *;
+                using iterator_category = std::forward_iterator_tag;
+
+                basic_iterator() = default;
+                basic_iterator(SlotT * slot, SlotT * end) noexcept
+                    : m_slot(slot)
+                    , m_end(end) {
+                    skip_empty();
+                }
+
+                template<typename OtherSlotT, typename OtherValueT, typename = std::enable_if_t<std::is_convertible<OtherSlotT *, SlotT *>::value>>
+                basic_iterator(basic_iterator<OtherSlotT, OtherValueT> const& other) noexcept
+                    : m_slot(other.m_slot)
+                    , m_end(other.m_end) {
+                }
+
+                auto operator*() const noexcept -> reference {
+                    return **m_slot;
+                }
+
+                auto operator->() const noexcept -> pointer {
+                    return &**m_slot;
+                }
+
+                auto operator++() noexcept -> basic_iterator & {
+                    ++m_slot;
+                    skip_empty();
+                    return *this;
+                }
+
+                auto operator++(int) noexcept -> basic_iterator {
+                    auto copy = *this;
+                    ++(*this);
+                    return copy;
+                }
+
+                auto operator==(basic_iterator const& other) const noexcept -> bool {
+                    return m_slot == other.m_slot;
+                }
+
+                auto operator!=(basic_iterator const& other) const noexcept -> bool {
+                    return !(*this == other);
+                }
+
+            private:
+                template<typename, typename>
+                friend class basic_iterator;
+
+                void skip_empty() noexcept {
+                    while(m_slot != m_end && !m_slot->has_value()) {
+                        ++m_slot;
+                    }
+                }
+
+                SlotT * m_slot = nullptr;
+                SlotT * m_end = nullptr;
+            };
+
+            using iterator = basic_iterator<slot_type, Value>;
+            using const_iterator = basic_iterator<slot_type const, Value const>;
+
+            flat_hash_table() = default;
+
+            explicit flat_hash_table(Allocator const& allocator)
+                : m_heap(slot_allocator(allocator)) {
+            }
+
+            flat_hash_table(flat_hash_table const&) = default;
+
+            flat_hash_table(flat_hash_table && other) noexcept(std::is_nothrow_move_constructible<Value>::value)
+                : m_inline(std::move(other.m_inline))
+                , m_heap(std::move(other.m_heap))
+                , m_size(std::exchange(other.m_size, 0))
+                , m_hash(std::move(other.m_hash))
+                , m_equal(std::move(other.m_equal)) {
+                other.m_heap.clear();
+                other.reset_inline();
+            }
+
+            auto operator=(flat_hash_table const& other) -> flat_hash_table & {
+                if(this != &other) {
+                    auto copy = flat_hash_table(other);
+                    *this = std::move(copy);
+                }
+                return *this;
+            }
+
+            auto operator=(flat_hash_table && other) noexcept(std::is_nothrow_move_constructible<Value>::value) -> flat_hash_table & {
+                if(this != &other) {
+                    reset_inline();
+                    for(std::size_t i = 0; i < InlineSlots; ++i) {
+                        if(other.m_inline[i]) {
+                            m_inline[i].emplace(std::move(*other.m_inline[i]));
+                        }
+                    }
+                    if(m_heap.get_allocator() == other.m_heap.get_allocator()) {
+                        m_heap.swap(other.m_heap);
+                    } else {
+                        auto heap = std::vector<slot_type, slot_allocator>(other.m_heap.size(), m_heap.get_allocator());
+                        for(std::size_t i = 0; i < heap.size(); ++i) {
+                            if(other.m_heap[i]) {
+                                heap[i].emplace(std::move(*other.m_heap[i]));
+                            }
+                        }
+                        m_heap.swap(heap);
+                    }
+                    m_size = std::exchange(other.m_size, 0);
+                    m_hash = std::move(other.m_hash);
+                    m_equal = std::move(other.m_equal);
+                    other.m_heap.clear();
+                    other.reset_inline();
+                }
+                return *this;
+            }
+
+            auto begin() noexcept -> iterator { return {slots(), slots() + capacity()}; }
+            auto end() noexcept -> iterator { return {slots() + capacity(), slots() + capacity()}; }
+            auto begin() const noexcept -> const_iterator { return {slots(), slots() + capacity()}; }
+            auto end() const noexcept -> const_iterator { return {slots() + capacity(), slots() + capacity()}; }
+
+            auto size() const noexcept -> size_type { return m_size; }
+            auto empty() const noexcept -> bool { return m_size == 0; }
+            auto capacity() const noexcept -> size_type { return m_heap.empty() ? InlineSlots : m_heap.size(); }
+
+            void clear() noexcept {
+                m_heap.clear();
+                reset_inline();
+                m_size = 0;
+            }
+
+            // Makes room for count values without rehashing
+            void reserve(size_type const count) {
+                auto new_capacity = capacity();
+                while(!fits(count, new_capacity)) {
+                    new_capacity *= 2;
+                }
+                if(new_capacity != capacity()) {
+                    rehash(new_capacity);
+                }
+            }
+
+            template<typename K>
+            auto find(K const& key) -> iterator {
+                auto const index = probe(key);
+                return slots()[index] ? iterator(slots() + index, slots() + capacity()) : end();
+            }
+
+            template<typename K>
+            auto find(K const& key) const -> const_iterator {
+                auto const index = probe(key);
+                return slots()[index] ? const_iterator(slots() + index, slots() + capacity()) : end();
+            }
+
+            template<typename K>
+            auto count(K const& key) const -> size_type {
+                return slots()[probe(key)] ? 1 : 0;
+            }
+
+            template<typename K>
+            auto contains(K const& key) const -> bool {
+                return count(key) != 0;
+            }
+
+            // Constructs a value from args only if key is not in the table yet
+            template<typename K, typename... Args>
+            auto emplace_key(K const& key, Args&&... args) -> std::pair<iterator, bool> {
+                auto index = probe(key);
+                if(slots()[index]) {
+                    return {iterator(slots() + index, slots() + capacity()), false};
+                }
+                if(!fits(m_size + 1, capacity())) {
+                    rehash(capacity() * 2);
+                    index = probe(key);
+                }
+                slots()[index].emplace(std::forward<Args>(args)...);
+                ++m_size;
+                return {iterator(slots() + index, slots() + capacity()), true};
+            }
+
+            template<typename K>
+            auto erase(K const& key) -> size_type {
+                auto const mask = capacity() - 1;
+                auto * const s = slots();
+                auto hole = probe(key);
+                if(!s[hole]) {
+                    return 0;
+                }
+
+                s[hole].reset();
+                --m_size;
+                // Shift back every following value of the probe run whose home slot does not lie between the hole and itself
+                for(auto next = (hole + 1) & mask; s[next]; next = (next + 1) & mask) {
+                    auto const home = home_slot(KeyOf()(*s[next]), mask);
+                    if(((next - home) & mask) >= ((next - hole) & mask)) {
+                        s[hole].emplace(std::move(*s[next]));
+                        s[next].reset();
+                        hole = next;
+                    }
+                }
+                return 1;
+            }
+
+        private:
+            // Tables stay at most 7/8 full, so that probing always ends at an empty slot
+            static constexpr auto fits(size_type const count, size_type const slot_count) noexcept -> bool {
+                return count * 8 <= slot_count * 7;
+            }
+
+            auto slots() noexcept -> slot_type * { return m_heap.empty() ? m_inline.data() : m_heap.data(); }
+            auto slots() const noexcept -> slot_type const* { return m_heap.empty() ? m_inline.data() : m_heap.data(); }
+
+            template<typename K>
+            auto home_slot(K const& key, size_type const mask) const noexcept -> size_type {
+                return mix_hash(m_hash(key)) & mask;
+            }
+
+            // Returns the slot holding key, or the empty slot where it would be inserted
+            template<typename K>
+            auto probe(K const& key) const -> size_type {
+                auto const mask = capacity() - 1;
+                auto const* const s = slots();
+                auto index = home_slot(key, mask);
+                while(s[index] && !m_equal(KeyOf()(*s[index]), key)) {
+                    index = (index + 1) & mask;
+                }
+                return index;
+            }
+
+            void rehash(size_type const new_capacity) {
+                auto slots_allocator = m_heap.get_allocator();
+                auto new_slots = std::vector<slot_type, slot_allocator>(new_capacity, slots_allocator);
+                auto const mask = new_capacity - 1;
+                auto * const old_slots = slots();
+                for(size_type i = 0; i < capacity(); ++i) {
+                    if(old_slots[i]) {
+                        auto index = home_slot(KeyOf()(*old_slots[i]), mask);
+                        while(new_slots[index]) {
+                            index = (index + 1) & mask;
+                        }
+                        new_slots[index].emplace(std::move(*old_slots[i]));
+                    }
+                }
+                reset_inline();
+                // Swapping rather than assigning, as slots holding a const key cannot be assigned
+                m_heap.swap(new_slots);
+            }
+
+            void reset_inline() noexcept {
+                if constexpr(std::is_trivially_copy_assignable_v<slot_type>) {
+                    // One unconditional overwrite, rather than a branch per slot on whether it is engaged
+                    m_inline = {};
+                } else {
+                    for(auto & slot : m_inline) {
+                        slot.reset();
+                    }
+                }
+            }
+
+            std::array<slot_type, InlineSlots> m_inline;
+            std::vector<slot_type, slot_allocator> m_heap;
+            size_type m_size = 0;
+            Hash m_hash;
+            KeyEqual m_equal;
+        };
+    }
+
+    template<typename Key, typename Value, typename Hash = typename default_hash<Key>::type, typename KeyEqual = std::equal_to<>,
+        std::size_t InlineSlots = 8, typename Allocator = std::allocator<std::pair<Key const, Value>>>
+    class flat_hash_map : public detail::flat_hash_table<std::pair<Key const, Value>, detail::first_key, Hash, KeyEqual, InlineSlots, Allocator> {
+        using base = detail::flat_hash_table<std::pair<Key const, Value>, detail::first_key, Hash, KeyEqual, InlineSlots, Allocator>;
+
+    public:
+        using mapped_type = Value;
+        using base::base;
+
+        template<typename... Args>
+        auto try_emplace(Key const& key, Args&&... args) -> std::pair<typename base::iterator, bool> {
+            return this->emplace_key(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        template<typename... Args>
+        auto try_emplace(Key && key, Args&&... args) -> std::pair<typename base::iterator, bool> {
+            // Probing only reads the key, which is moved into the table after the slot is found
+            return this->emplace_key(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        auto operator[](Key const& key) -> Value & {
+            return try_emplace(key).first->second;
+        }
+
+        auto operator[](Key && key) -> Value & {
+            return try_emplace(std::move(key)).first->second;
+        }
+    };
+
+    template<typename Key, typename Hash = typename default_hash<Key>::type, typename KeyEqual = std::equal_to<>,
+        std::size_t InlineSlots = 8, typename Allocator = std::allocator<Key>>
+    class flat_hash_set : public detail::flat_hash_table<Key, detail::identity_key, Hash, KeyEqual, InlineSlots, Allocator> {
+        using base = detail::flat_hash_table<Key, detail::identity_key, Hash, KeyEqual, InlineSlots, Allocator>;
+
+    public:
+        // Keys cannot be changed in place, as that would move them away from their slot
+        using iterator = typename base::const_iterator;
+        using base::base;
+
+        auto begin() const noexcept -> iterator { return base::begin(); }
+        auto end() const noexcept -> iterator { return base::end(); }
+
+        template<typename K>
+        auto find(K const& key) const -> iterator {
+            return base::find(key);
+        }
+
+        auto insert(Key const& key) -> std::pair<iterator, bool> {
+            return this->emplace_key(key, key);
+        }
+
+        auto insert(Key && key) -> std::pair<iterator, bool> {
+            return this->emplace_key(key, std::move(key));
+        }
+
+        template<typename... Args>
+        auto emplace(Args&&... args) -> std::pair<iterator, bool> {
+            auto key = Key(std::forward<Args>(args)...);
+            return insert(std::move(key));
+        }
+    };
 }
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include "profile.h"
+
+#include <cstdlib>
+#include <new>
+
+#if KAB_TRACK_ALLOCATIONS
+#if defined(_WIN32)
+#include <malloc.h>
+#define KAB_ALLOCATION_SIZE(ptr) ::_msize(ptr)
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#define KAB_ALLOCATION_SIZE(ptr) ::malloc_usable_size(ptr)
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define KAB_ALLOCATION_SIZE(ptr) ::malloc_size(ptr)
+#endif
+
+// Kept apart from profile.cpp so that the replaced operators are never inlined into the profiler's own containers.
+// The nothrow and array forms forward to these by default
+void* operator new(std::size_t size) {
+    auto const ptr = std::malloc(size == 0 ? 1 : size);
+    if(ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    if(kab_advent::profile::enabled()) {
+        kab_advent::profile::detail::track_allocation(KAB_ALLOCATION_SIZE(ptr));
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    if(ptr != nullptr && kab_advent::profile::enabled()) {
+        kab_advent::profile::detail::track_deallocation(KAB_ALLOCATION_SIZE(ptr));
+    }
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+#endif
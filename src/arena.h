@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+namespace kab_advent {
+    // Owns a value together with the monotonic arena its containers allocate from. Parsers build their
+    // input directly into the arena, and every node is released at once when the parsed input is dropped.
+    // The arena never moves, so moving the owner keeps the value's allocations valid
+    template<typename T>
+    class arena_owned {
+    public:
+        explicit arena_owned(std::size_t const initial_size = 4096)
+            : m_arena(std::make_unique<std::pmr::monotonic_buffer_resource>(initial_size))
+            , m_value(m_arena.get()) {
+        }
+        arena_owned(arena_owned &&) noexcept = default;
+        // A moved-to value would allocate from the old arena, so only construction can move
+        auto operator=(arena_owned &&) -> arena_owned & = delete;
+
+        auto resource() const noexcept -> std::pmr::memory_resource* { return m_arena.get(); }
+
+        auto operator*() noexcept -> T& { return m_value; }
+        auto operator*() const noexcept -> T const& { return m_value; }
+        auto operator->() noexcept -> T* { return &m_value; }
+        auto operator->() const noexcept -> T const* { return &m_value; }
+
+    private:
+        // Declared first so that the value is destroyed before its arena
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> m_arena;
+        T m_value;
+    };
+}
@@ -0,0 +1,196 @@
+#include "baseline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <sstream>
+#include <system_error>
+
+#include "algorithm.h"
+#include "conversion.h"
+#include "input.h"
+#include "parser.h"
+
+namespace kab_advent::baseline {
+    namespace {
+        using namespace std::literals;
+
+        constexpr auto header = "# aoc_bench baseline v1: <day> <part> <input bytes> <count> <parse ns> <solve ns> <input path>"sv;
+
+        template<std::size_t N>
+        auto invalid_line(char const (&reason)[N]) -> error_info {
+            return error_info(std::make_error_code(std::errc::invalid_argument), reason);
+        }
+
+        template<typename IntegerT>
+        auto consume_integer(std::string_view & line) -> expected<IntegerT> {
+            auto const result = to_integer<IntegerT>(line);
+            if(!result) {
+                return make_unexpected(result.error());
+            }
+            line.remove_prefix(static_cast<std::size_t>(std::distance(line.data(), result.value().conversion_end)));
+            return result.value().data;
+        }
+
+        auto parse_entry(std::string_view line) -> expected<entry> {
+            auto const day = consume_integer<int>(line);
+            if(!day) {
+                return make_unexpected(day.error());
+            }
+            auto const part = consume_integer<int>(line);
+            if(!part) {
+                return make_unexpected(part.error());
+            }
+            auto const input_bytes = consume_integer<std::size_t>(line);
+            if(!input_bytes) {
+                return make_unexpected(input_bytes.error());
+            }
+            auto const count = consume_integer<std::size_t>(line);
+            if(!count) {
+                return make_unexpected(count.error());
+            }
+
+            auto samples = std::vector<std::int64_t>(2 * count.value());
+            auto const decoded = to_ints(line, gsl::span<std::int64_t>(samples));
+            if(decoded.data != samples.size()) {
+                return make_unexpected(invalid_line("Expected {} timings").append(samples.size()));
+            }
+            line.remove_prefix(static_cast<std::size_t>(std::distance(line.data(), decoded.conversion_end)));
+
+            auto const input_path = right_trim(left_trim(line));
+            if(input_path.empty()) {
+                return make_unexpected(invalid_line("Missing input path"));
+            }
+
+            auto const middle = samples.begin() + static_cast<std::ptrdiff_t>(count.value());
+            return entry{day.value(), part.value(), std::string(input_path), input_bytes.value(),
+                std::vector<std::int64_t>(samples.begin(), middle), std::vector<std::int64_t>(middle, samples.end())};
+        }
+
+        void write_samples(std::ostream & o, gsl::span<std::int64_t const> samples) {
+            for(auto const& ns : samples) {
+                o << (&ns == samples.data() ? " " : ",") << ns;
+            }
+        }
+
+        struct log_moments {
+            double mean;
+            double variance;
+            double count;
+        };
+
+        // Sample mean and unbiased variance of the log timings. Zero timings are clamped to a nanosecond
+        auto moments(gsl::span<std::int64_t const> samples) -> log_moments {
+            auto const count = static_cast<double>(samples.size());
+            auto sum = 0.0;
+            for(auto const ns : samples) {
+                sum += std::log(static_cast<double>(std::max<std::int64_t>(ns, 1)));
+            }
+            auto const mean = sum / count;
+            auto squares = 0.0;
+            for(auto const ns : samples) {
+                auto const deviation = std::log(static_cast<double>(std::max<std::int64_t>(ns, 1))) - mean;
+                squares += deviation * deviation;
+            }
+            return {mean, samples.size() > 1 ? squares / (count - 1.0) : 0.0, count};
+        }
+
+        // Two-sided 95% quantile of Student's t distribution, from the normal quantile by the Cornish-Fisher
+        // expansion (Abramowitz and Stegun 26.7.5). Within 3% of the exact value from 2 degrees of freedom on
+        auto t_quantile_95(double degrees_of_freedom) noexcept -> double {
+            auto const z = 1.959963984540054;
+            auto const z3 = z * z * z;
+            auto const z5 = z3 * z * z;
+            auto const z7 = z5 * z * z;
+            auto const v = std::max(degrees_of_freedom, 1.0);
+            return z + (z3 + z) / (4.0 * v) + (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * v * v)
+                + (3.0 * z7 + 19.0 * z5 + 17.0 * z3 - 15.0 * z) / (384.0 * v * v * v);
+        }
+    }
+
+    auto save(std::string const& path, gsl::span<entry const> entries) -> bool {
+        auto o = std::ostringstream();
+        o << header << "\n";
+        for(auto const& e : entries) {
+            o << e.day << " " << e.part << " " << e.input_bytes << " " << e.parse_ns.size();
+            write_samples(o, e.parse_ns);
+            write_samples(o, e.solve_ns);
+            o << " " << e.input_path << "\n";
+        }
+        return replace_file(path, o.str());
+    }
+
+    auto load(std::string_view path) -> expected<std::vector<entry>> {
+        auto const buffer = input_buffer::from_file(path);
+        if(!buffer) {
+            return make_unexpected(buffer.error());
+        }
+
+        auto entries = std::vector<entry>();
+        auto line_number = 0;
+        auto lines = line_scanner(buffer.value().view());
+        while(!lines.empty()) {
+            auto const line = left_trim(lines.consume_line());
+            ++line_number;
+            if(line.empty() || line.front() == '#') {
+                continue;
+            }
+
+            auto e = parse_entry(line);
+            if(!e) {
+                return make_unexpected(error_info(e.error()).at_line("Baseline", line_number));
+            }
+            entries.push_back(std::move(e).value());
+        }
+        return entries;
+    }
+
+    auto find(gsl::span<entry const> entries, int day, int part, std::string_view input_path) -> entry const* {
+        auto const it = std::find_if(entries.begin(), entries.end(), [&] (entry const& e) {
+            return e.day == day && e.part == part && e.input_path == input_path;
+        });
+        return it != entries.end() ? &*it : nullptr;
+    }
+
+    auto compare(gsl::span<std::int64_t const> before, gsl::span<std::int64_t const> after) -> ratio_interval {
+        if(before.empty() || after.empty()) {
+            return {std::nan(""), std::nan(""), std::nan("")};
+        }
+
+        auto const b = moments(before);
+        auto const a = moments(after);
+        auto const b_error = b.variance / b.count;
+        auto const a_error = a.variance / a.count;
+        auto const standard_error = std::sqrt(b_error + a_error);
+        auto const difference = a.mean - b.mean;
+        if(standard_error == 0.0) {
+            return {std::exp(difference), std::exp(difference), std::exp(difference)};
+        }
+
+        // Welch-Satterthwaite degrees of freedom, for samples that need not share a variance
+        auto const df_denominator = (b.count > 1.0 ? b_error * b_error / (b.count - 1.0) : 0.0)
+            + (a.count > 1.0 ? a_error * a_error / (a.count - 1.0) : 0.0);
+        auto const degrees_of_freedom = df_denominator > 0.0 ? (b_error + a_error) * (b_error + a_error) / df_denominator : 1.0;
+        auto const margin = t_quantile_95(degrees_of_freedom) * standard_error;
+        return {std::exp(difference), std::exp(difference - margin), std::exp(difference + margin)};
+    }
+
+    auto classify(ratio_interval const& interval, double threshold) noexcept -> verdict {
+        if(interval.low > 1.0 + threshold) {
+            return verdict::regressed;
+        }
+        if(interval.high < 1.0 / (1.0 + threshold)) {
+            return verdict::improved;
+        }
+        return verdict::unchanged;
+    }
+
+    auto to_string(verdict v) noexcept -> std::string_view {
+        switch(v) {
+            case verdict::improved: return "improved";
+            case verdict::regressed: return "REGRESSED";
+            case verdict::unchanged: break;
+        }
+        return "unchanged";
+    }
+}
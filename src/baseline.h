@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <gsl/span>
+
+#include "error.h"
+
+// Benchmark baselines: the raw timing samples of one aoc_bench run, saved so that a later build can be compared
+// against them. Comparisons use confidence intervals over all samples rather than single timings
+namespace kab_advent::baseline {
+    struct entry {
+        int day;
+        int part;
+        std::string input_path;
+        std::size_t input_bytes;
+        std::vector<std::int64_t> parse_ns;
+        std::vector<std::int64_t> solve_ns;
+    };
+
+    // One "<day> <part> <input bytes> <count> <parse samples> <solve samples> <input path>" line per entry, where
+    // both sample lists hold count comma-separated nanosecond timings. Lines starting with '#' are comments
+    auto save(std::string const& path, gsl::span<entry const> entries) -> bool;
+    auto load(std::string_view path) -> expected<std::vector<entry>>;
+
+    auto find(gsl::span<entry const> entries, int day, int part, std::string_view input_path) -> entry const*;
+
+    // The ratio of the geometric mean of after to that of before, with its 95% confidence interval from Welch's t
+    // interval on log timings. Timings are skewed with a long slow tail, which the log scale tames
+    struct ratio_interval {
+        double ratio;
+        double low;
+        double high;
+    };
+
+    auto compare(gsl::span<std::int64_t const> before, gsl::span<std::int64_t const> after) -> ratio_interval;
+
+    enum class verdict {
+        unchanged,
+        improved,
+        regressed,
+    };
+
+    // Significant only when the whole interval lies beyond the threshold, a relative change such as 0.05 for 5%
+    auto classify(ratio_interval const& interval, double threshold) noexcept -> verdict;
+
+    auto to_string(verdict v) noexcept -> std::string_view;
+}
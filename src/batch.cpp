@@ -0,0 +1,270 @@
+#include "batch.h"
+
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "algorithm.h"
+#include "conversion.h"
+#include "input.h"
+#include "parse_cache.h"
+#include "parser.h"
+#include "profile.h"
+#include "result_writer.h"
+#include "solver.h"
+#include "thread_pool.h"
+
+namespace kab_advent {
+    namespace {
+        using namespace std::literals;
+
+        using parse_function = decltype(solver::parse);
+
+        // Computes each value once, on the first thread asking for it, while other threads asking for the same key wait.
+        // Every user of a key is announced with expect before any of them runs, and the value is dropped once the
+        // last of them calls release
+        template<typename Key, typename Value>
+        class shared_cache {
+        public:
+            void expect(Key const& key) {
+                auto const lock = std::lock_guard<std::mutex>(m_mutex);
+                ++m_entries[key].users;
+            }
+
+            template<typename MakeF>
+            auto get(Key const& key, MakeF&& make) -> Value const& {
+                auto lock = std::unique_lock<std::mutex>(m_mutex);
+                auto & entry = m_entries[key];
+                lock.unlock();
+
+                std::call_once(entry.once, [&entry, &make] { entry.value.emplace(make()); });
+                return *entry.value;
+            }
+
+            void release(Key const& key) noexcept {
+                auto lock = std::unique_lock<std::mutex>(m_mutex);
+                auto const it = m_entries.find(key);
+                if(it == m_entries.end() || --it->second.users != 0) {
+                    return;
+                }
+                // The value is destroyed once the lock is released, so that other keys are not held up meanwhile
+                auto const node = m_entries.extract(it);
+                lock.unlock();
+            }
+
+        private:
+            struct entry {
+                std::once_flag once;
+                std::optional<Value> value;
+                std::size_t users = 0;
+            };
+
+            std::mutex m_mutex;
+            std::map<Key, entry> m_entries;
+        };
+
+        // What parsing an input cost is kept with it, and reported by every job sharing it
+        struct loaded_input {
+            expected<parsed_input> parsed;
+            profile::phase_sample parse;
+            std::size_t input_bytes;
+        };
+
+        struct input_cache {
+            shared_cache<std::string, expected<input_buffer>> buffers;
+            shared_cache<std::pair<std::string, parse_function>, loaded_input> parsed;
+        };
+
+        // A job's hold on its input, announced when the batch is planned and released when the job is done with it,
+        // whether it succeeded or not. The parsed input is released before the buffer its views may point into
+        class input_lease {
+        public:
+            input_lease(input_cache & inputs, solver const& s, std::string const& input_path)
+                : m_inputs(inputs)
+                , m_key(input_path, s.parse) {
+            }
+            input_lease(input_lease const&) = delete;
+            auto operator=(input_lease const&) -> input_lease & = delete;
+            ~input_lease() {
+                m_inputs.parsed.release(m_key);
+                m_inputs.buffers.release(m_key.first);
+            }
+
+            static void expect(input_cache & inputs, solver const& s, std::string const& input_path) {
+                inputs.buffers.expect(input_path);
+                inputs.parsed.expect({input_path, s.parse});
+            }
+
+        private:
+            input_cache & m_inputs;
+            std::pair<std::string, parse_function> m_key;
+        };
+
+        struct job_result {
+            expected<answer> value;
+            solve_stats stats;
+        };
+
+        auto parse_job(std::string_view line) -> expected<batch_job> {
+            auto const day_result = to_int(line);
+            if(!day_result) {
+                return make_unexpected(day_result.error());
+            }
+            line = line.substr(std::distance(line.data(), day_result.value().conversion_end));
+
+            auto const part_result = to_int(line);
+            if(!part_result) {
+                return make_unexpected(part_result.error());
+            }
+            line = line.substr(std::distance(line.data(), part_result.value().conversion_end));
+
+            auto const input_path = right_trim(left_trim(line));
+            if(input_path.empty()) {
+                return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing input path"));
+            }
+
+            return batch_job{day_result.value().data, part_result.value().data, std::string(input_path)};
+        }
+
+        auto load_parsed_input(solver const& s, std::string const& input_path, input_cache & inputs) -> loaded_input const& {
+            return inputs.parsed.get({input_path, s.parse}, [&s, &input_path, &inputs] () -> loaded_input {
+                auto const& buffer = inputs.buffers.get(input_path, [&input_path] {
+                    auto const scope = profile::scoped_phase(profile::phase::input);
+                    return input_buffer::from_file(input_path);
+                });
+                if(!buffer) {
+                    return {make_unexpected(buffer.error()), {}, 0};
+                }
+                auto loaded = loaded_input{parsed_input(), {}, buffer.value().view().size()};
+                {
+                    auto const scope = profile::scoped_phase(profile::phase::parse, &loaded.parse);
+                    loaded.parsed = parse_cache::parse(s, buffer.value().view());
+                }
+                return loaded;
+            });
+        }
+
+        auto run_job(batch_job const& job, input_cache & inputs, solve_stats & stats) -> expected<answer> {
+            auto const tag = profile::scoped_job(job.day, job.part);
+            auto const* const solver = find_solver(job.day, job.part);
+            if(solver == nullptr) {
+                return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Day {} is not implemented")
+                    .append(job.day).append(" part ").append(job.part));
+            }
+
+            auto const lease = input_lease(inputs, *solver, job.input_path);
+            auto const& in = load_parsed_input(*solver, job.input_path, inputs);
+            stats.parse = in.parse;
+            stats.input_bytes = in.input_bytes;
+            if(!in.parsed) {
+                return make_unexpected(in.parsed.error());
+            }
+
+            auto const scope = profile::scoped_phase(profile::phase::solve, &stats.solve);
+            return solver->solve(in.parsed.value());
+        }
+    }
+
+    auto parse_manifest(std::string_view manifest) -> expected<std::vector<batch_job>> {
+        auto jobs = std::vector<batch_job>();
+        auto line_number = 0;
+        auto lines = line_scanner(manifest);
+        while(!lines.empty()) {
+            auto const line = left_trim(lines.consume_line());
+            ++line_number;
+            if(line.empty() || line.front() == '#') {
+                continue;
+            }
+
+            auto job = parse_job(line);
+            if(!job) {
+                return make_unexpected(error_info(job.error()).at_line("Manifest", line_number));
+            }
+            jobs.push_back(std::move(job).value());
+        }
+        return jobs;
+    }
+
+    auto parse_jobs_option(gsl::span<std::string_view const> args) -> std::size_t {
+        if(args.size() < 1 || args[0] != "--jobs") {
+            return thread_pool::default_thread_count();
+        }
+        if(args.size() < 2) {
+            throw std::runtime_error("Missing thread count after --jobs");
+        }
+        auto const jobs_result = to_int(args[1]);
+        if(!jobs_result || jobs_result.value().data < 1) {
+            throw std::runtime_error("Expected a positive thread count after --jobs");
+        }
+        return static_cast<std::size_t>(jobs_result.value().data);
+    }
+
+    auto batch(gsl::span<std::string_view const> args) -> int {
+        if(args.size() < 1) {
+            throw std::runtime_error("Missing manifest after --batch");
+        }
+
+        auto const thread_count = parse_jobs_option(args.subspan(1));
+
+        auto const manifest = input_buffer::from_file(args[0]);
+        if(!manifest) {
+            std::cerr << manifest.error() << "\n";
+            return EXIT_FAILURE;
+        }
+
+        auto const jobs = parse_manifest(manifest.value().view());
+        if(!jobs) {
+            std::cerr << jobs.error() << "\n";
+            return EXIT_FAILURE;
+        }
+
+        // Each input is dropped as soon as the last job reading it is done, rather than at the end of the batch
+        auto inputs = input_cache();
+        for(auto const& job : jobs.value()) {
+            if(auto const* const solver = find_solver(job.day, job.part)) {
+                input_lease::expect(inputs, *solver, job.input_path);
+            }
+        }
+
+        auto pool = thread_pool(thread_count);
+        auto results = std::vector<std::future<job_result>>();
+        results.reserve(jobs.value().size());
+        for(auto const& job : jobs.value()) {
+            results.push_back(pool.submit([&job, &inputs] {
+                auto stats = solve_stats();
+                // Whatever a job throws, from loading its input to solving it, is that job's error record only
+                try {
+                    auto value = run_job(job, inputs, stats);
+                    return job_result{std::move(value), stats};
+                } catch(std::exception const& e) {
+                    return job_result{make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "{}", e.what())), stats};
+                }
+            }));
+        }
+
+        // Results are written in submission order. They are buffered while later jobs are already done, and flushed
+        // before waiting on one that is not, so that every finished result goes out without waiting on later ones
+        auto status = EXIT_SUCCESS;
+        auto writer = result_writer(std::cout, get_output_format());
+        for(std::size_t i = 0; i < results.size(); ++i) {
+            auto const& job = jobs.value()[i];
+            if(results[i].wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                writer.flush();
+            }
+            auto const result = results[i].get();
+            auto const tag = profile::scoped_job(job.day, job.part);
+            auto const scope = profile::scoped_phase(profile::phase::output);
+            writer.write(job.day, job.part, result.value, &result.stats);
+            if(!result.value) {
+                status = EXIT_FAILURE;
+            }
+        }
+
+        return status;
+    }
+}
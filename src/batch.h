@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <gsl/span>
+
+#include "error.h"
+
+namespace kab_advent {
+    struct batch_job {
+        int day;
+        int part;
+        std::string input_path;
+    };
+
+    // Manifest lines are "<day> <part> <input path>". Blank lines and lines starting with '#' are skipped
+    auto parse_manifest(std::string_view manifest) -> expected<std::vector<batch_job>>;
+
+    // Reads the "--jobs <n>" option when args start with it, and otherwise defaults to all hardware threads
+    auto parse_jobs_option(gsl::span<std::string_view const> args) -> std::size_t;
+
+    // Solves every job of the manifest file named by args[0] in one process, spread over a thread pool
+    // ("--jobs <n>" threads, all hardware threads by default). Writes one record per job in manifest order, in the
+    // output format chosen with --format. Jobs naming the same input file share its loaded and parsed input, which is
+    // released once the last of them is done
+    auto batch(gsl::span<std::string_view const> args) -> int;
+}
@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "baseline.h"
+#include "batch.h"
+#include "conversion.h"
+#include "input.h"
+#include "solver.h"
+
+namespace kab_advent {
+    namespace {
+        using namespace std::literals;
+        using bench_clock = std::chrono::steady_clock;
+
+        struct bench_options {
+            int warmup = 3;
+            int iterations = 20;
+            // Relative change a comparison must exceed, beyond its confidence interval, to count
+            double threshold = 0.05;
+            std::string_view manifest;
+            std::string_view save_baseline;
+            std::string_view compare_baseline;
+        };
+
+        struct timing_summary {
+            std::int64_t min_ns;
+            std::int64_t median_ns;
+            std::int64_t p99_ns;
+        };
+
+        struct phase_comparison {
+            baseline::ratio_interval interval;
+            baseline::verdict verdict;
+        };
+
+        struct comparison {
+            phase_comparison parse;
+            phase_comparison solve;
+        };
+
+        struct bench_result {
+            batch_job job;
+            std::size_t input_bytes = 0;
+            std::vector<std::int64_t> parse_samples;
+            std::vector<std::int64_t> solve_samples;
+            timing_summary parse = {};
+            timing_summary solve = {};
+            std::string answer;
+            std::string error;
+            std::optional<comparison> compared;
+        };
+
+        template<typename F>
+        auto time_ns(F&& f) -> std::int64_t {
+            auto const start = bench_clock::now();
+            f();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock::now() - start).count();
+        }
+
+        // Nearest-rank percentiles over the sorted samples
+        auto summarize(std::vector<std::int64_t> samples) -> timing_summary {
+            std::sort(samples.begin(), samples.end());
+            auto const percentile = [&samples] (double p) {
+                auto const rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(samples.size())));
+                return samples[std::min(samples.size(), std::max<std::size_t>(rank, 1)) - 1];
+            };
+            return {samples.front(), percentile(0.5), percentile(0.99)};
+        }
+
+        auto parse_count(gsl::span<std::string_view const> args, std::string_view option) -> int {
+            if(args.size() < 2) {
+                throw std::runtime_error("Missing count after "s.append(option));
+            }
+            auto const count = to_int(args[1]);
+            if(!count || count.value().data < 0) {
+                throw std::runtime_error("Expected a count after "s.append(option).append(", got \"").append(args[1]).append("\""));
+            }
+            return count.value().data;
+        }
+
+        auto parse_options(gsl::span<std::string_view const> args) -> bench_options {
+            auto options = bench_options();
+            while(args.size() > 0) {
+                if(args[0] == "--warmup") {
+                    options.warmup = parse_count(args, args[0]);
+                    args = args.subspan(2);
+                } else if(args[0] == "--iterations") {
+                    options.iterations = std::max(parse_count(args, args[0]), 1);
+                    args = args.subspan(2);
+                } else if(args[0] == "--threshold") {
+                    options.threshold = parse_count(args, args[0]) / 100.0;
+                    args = args.subspan(2);
+                } else if(args[0] == "--save-baseline" || args[0] == "--compare") {
+                    if(args.size() < 2) {
+                        throw std::runtime_error("Missing baseline file after "s.append(args[0]));
+                    }
+                    (args[0] == "--compare" ? options.compare_baseline : options.save_baseline) = args[1];
+                    args = args.subspan(2);
+                } else if(options.manifest.empty()) {
+                    options.manifest = args[0];
+                    args = args.subspan(1);
+                } else {
+                    throw std::runtime_error("Invalid parameter \""s.append(args[0]).append("\""));
+                }
+            }
+
+            if(options.manifest.empty()) {
+                throw std::runtime_error("Usage: aoc_bench [--warmup <n>] [--iterations <n>] [--save-baseline <file>] [--compare <file>] [--threshold <percent>] <manifest>");
+            }
+            return options;
+        }
+
+        auto bench_job(batch_job const& job, bench_options const& options) -> bench_result {
+            auto result = bench_result();
+            result.job = job;
+            auto const* const solver = find_solver(job.day, job.part);
+            if(solver == nullptr) {
+                result.error = "Day "s.append(std::to_string(job.day)).append(" part ").append(std::to_string(job.part)).append(" is not implemented");
+                return result;
+            }
+
+            auto const buffer = input_buffer::from_file(job.input_path);
+            if(!buffer) {
+                result.error = buffer.error().get_error_message();
+                return result;
+            }
+            auto const text = buffer.value().view();
+            result.input_bytes = text.size();
+
+            try {
+                auto parsed = solver->parse(text);
+                if(!parsed) {
+                    result.error = parsed.error().get_error_message();
+                    return result;
+                }
+
+                auto parse_samples = std::vector<std::int64_t>();
+                auto solve_samples = std::vector<std::int64_t>();
+                auto last_answer = answer();
+                for(int i = 0; i < options.warmup + options.iterations; ++i) {
+                    // The previous iteration's results are freed before the clock starts, so that each phase only
+                    // times building its own
+                    parsed.value().reset();
+                    last_answer = answer();
+                    auto const parse_ns = time_ns([&] { parsed = solver->parse(text); });
+                    auto const solve_ns = time_ns([&] { last_answer = solver->solve(parsed.value()); });
+                    if(i >= options.warmup) {
+                        parse_samples.push_back(parse_ns);
+                        solve_samples.push_back(solve_ns);
+                    }
+                }
+
+                result.parse = summarize(parse_samples);
+                result.solve = summarize(solve_samples);
+                result.parse_samples = std::move(parse_samples);
+                result.solve_samples = std::move(solve_samples);
+                auto formatted = std::ostringstream();
+                formatted << last_answer;
+                result.answer = formatted.str();
+            } catch(std::exception const& e) {
+                result.error = e.what();
+            }
+            return result;
+        }
+
+        // Phases this short are dominated by the clock's own overhead, so they are never flagged
+        constexpr auto min_compared_ns = std::int64_t{1000};
+
+        auto compare_phase(std::vector<std::int64_t> const& before, std::vector<std::int64_t> const& after, double threshold) -> phase_comparison {
+            auto const interval = baseline::compare(before, after);
+            if(summarize(before).median_ns < min_compared_ns && summarize(after).median_ns < min_compared_ns) {
+                return {interval, baseline::verdict::unchanged};
+            }
+            return {interval, baseline::classify(interval, threshold)};
+        }
+
+        // Compares each result with the baseline entry for the same job, when there is one with the same input size
+        auto compare_results(gsl::span<bench_result> results, gsl::span<baseline::entry const> entries, double threshold) -> bool {
+            auto regressed = false;
+            for(auto & r : results) {
+                auto const* const before = baseline::find(entries, r.job.day, r.job.part, r.job.input_path);
+                if(!r.error.empty() || before == nullptr || before->input_bytes != r.input_bytes) {
+                    continue;
+                }
+                r.compared = comparison{
+                    compare_phase(before->parse_ns, r.parse_samples, threshold),
+                    compare_phase(before->solve_ns, r.solve_samples, threshold),
+                };
+                regressed = regressed
+                    || r.compared->parse.verdict == baseline::verdict::regressed
+                    || r.compared->solve.verdict == baseline::verdict::regressed;
+            }
+            return regressed;
+        }
+
+        auto make_baseline(gsl::span<bench_result const> results) -> std::vector<baseline::entry> {
+            auto entries = std::vector<baseline::entry>();
+            for(auto const& r : results) {
+                if(r.error.empty()) {
+                    entries.push_back(baseline::entry{r.job.day, r.job.part, r.job.input_path, r.input_bytes, r.parse_samples, r.solve_samples});
+                }
+            }
+            return entries;
+        }
+
+        auto write_json_string(std::ostream & o, std::string_view s) -> std::ostream& {
+            o << '"';
+            for(auto const c : s) {
+                switch(c) {
+                    case '"': o << "\\\""; break;
+                    case '\\': o << "\\\\"; break;
+                    case '\n': o << "\\n"; break;
+                    case '\t': o << "\\t"; break;
+                    default:
+                        if(static_cast<unsigned char>(c) < 0x20) {
+                            o << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+                        } else {
+                            o << c;
+                        }
+                }
+            }
+            return o << '"';
+        }
+
+        auto write_json_summary(std::ostream & o, timing_summary const& t) -> std::ostream& {
+            return o << "{\"min_ns\":" << t.min_ns << ",\"median_ns\":" << t.median_ns << ",\"p99_ns\":" << t.p99_ns << "}";
+        }
+
+        auto write_json_comparison(std::ostream & o, phase_comparison const& c) -> std::ostream& {
+            o << "{\"ratio\":" << c.interval.ratio << ",\"low\":" << c.interval.low << ",\"high\":" << c.interval.high << ",\"verdict\":";
+            return write_json_string(o, baseline::to_string(c.verdict)) << "}";
+        }
+
+        void write_json(std::ostream & o, bench_options const& options, gsl::span<bench_result const> results) {
+            o << "{\"warmup\":" << options.warmup << ",\"iterations\":" << options.iterations << ",\"benchmarks\":[";
+            for(auto const& r : results) {
+                o << (&r == results.data() ? "\n" : ",\n");
+                o << "{\"day\":" << r.job.day << ",\"part\":" << r.job.part << ",\"input\":";
+                write_json_string(o, r.job.input_path) << ",\"input_bytes\":" << r.input_bytes;
+                if(!r.error.empty()) {
+                    write_json_string(o << ",\"error\":", r.error) << "}";
+                    continue;
+                }
+                write_json_summary(o << ",\"parse\":", r.parse);
+                write_json_summary(o << ",\"solve\":", r.solve);
+                if(r.compared) {
+                    write_json_comparison(o << ",\"compared\":{\"parse\":", r.compared->parse);
+                    write_json_comparison(o << ",\"solve\":", r.compared->solve) << "}";
+                }
+                write_json_string(o << ",\"answer\":", r.answer) << "}";
+            }
+            o << "\n]}\n";
+        }
+
+        void write_table(std::ostream & o, gsl::span<bench_result const> results) {
+            o << "day part      parse min/median/p99 (us)      solve min/median/p99 (us)\n";
+            auto const us = [] (std::int64_t ns) { return static_cast<double>(ns) / 1000.0; };
+            for(auto const& r : results) {
+                o << std::setw(3) << r.job.day << std::setw(5) << r.job.part << "  ";
+                if(!r.error.empty()) {
+                    o << "error: " << r.error << "\n";
+                    continue;
+                }
+                o << std::fixed << std::setprecision(1)
+                    << std::setw(10) << us(r.parse.min_ns) << std::setw(10) << us(r.parse.median_ns) << std::setw(10) << us(r.parse.p99_ns) << "  "
+                    << std::setw(10) << us(r.solve.min_ns) << std::setw(10) << us(r.solve.median_ns) << std::setw(10) << us(r.solve.p99_ns) << "\n";
+            }
+        }
+
+        // Ratios are new time over baseline time, with their 95% confidence intervals
+        void write_comparison_table(std::ostream & o, gsl::span<bench_result const> results) {
+            o << "day part      parse ratio [95% CI]                 solve ratio [95% CI]\n";
+            auto const phase = [&o] (phase_comparison const& c) {
+                o << std::fixed << std::setprecision(3) << std::setw(8) << c.interval.ratio
+                    << " [" << std::setw(5) << c.interval.low << ", " << std::setw(5) << c.interval.high << "] "
+                    << std::setw(9) << std::left << baseline::to_string(c.verdict) << std::right;
+            };
+            for(auto const& r : results) {
+                o << std::setw(3) << r.job.day << std::setw(5) << r.job.part << "  ";
+                if(!r.compared) {
+                    o << (r.error.empty() ? "not in baseline" : "error") << "\n";
+                    continue;
+                }
+                phase(r.compared->parse);
+                o << "  ";
+                phase(r.compared->solve);
+                o << "\n";
+            }
+        }
+    }
+}
+
+// Runs every job of a batch manifest ("<day> <part> <input path>" lines) with warmup and repeated iterations,
+// timing parsing and solving separately. JSON goes to stdout and a readable table to stderr.
+// "--save-baseline <file>" records every timing sample, and "--compare <file>" checks each job against a recorded
+// baseline, exiting with failure when any job is significantly slower than the threshold allows
+int main( int argc, const char* argv[] ) try {
+	std::cout.sync_with_stdio(false);
+	std::cerr.sync_with_stdio(false);
+
+	auto const args = std::vector<std::string_view>( argv + 1, argv + argc );
+	auto const options = kab_advent::parse_options( args );
+
+	auto const manifest = kab_advent::input_buffer::from_file( options.manifest );
+	if ( !manifest ) {
+		std::cerr << manifest.error() << "\n";
+		return EXIT_FAILURE;
+	}
+	auto const jobs = kab_advent::parse_manifest( manifest.value().view() );
+	if ( !jobs ) {
+		std::cerr << jobs.error() << "\n";
+		return EXIT_FAILURE;
+	}
+
+	auto before = std::vector<kab_advent::baseline::entry>();
+	if ( !options.compare_baseline.empty() ) {
+		auto loaded = kab_advent::baseline::load( options.compare_baseline );
+		if ( !loaded ) {
+			std::cerr << loaded.error() << "\n";
+			return EXIT_FAILURE;
+		}
+		before = std::move( loaded ).value();
+	}
+
+	auto results = std::vector<kab_advent::bench_result>();
+	for ( auto const& job : jobs.value() ) {
+		results.push_back( kab_advent::bench_job( job, options ) );
+	}
+
+	auto const regressed = !options.compare_baseline.empty() && kab_advent::compare_results( results, before, options.threshold );
+	kab_advent::write_json( std::cout, options, results );
+	kab_advent::write_table( std::cerr, results );
+	if ( !options.compare_baseline.empty() ) {
+		kab_advent::write_comparison_table( std::cerr, results );
+	}
+
+	if ( !options.save_baseline.empty() && !kab_advent::baseline::save( std::string( options.save_baseline ), kab_advent::make_baseline( results ) ) ) {
+		std::cerr << "Could not write baseline \"" << options.save_baseline << "\"\n";
+		return EXIT_FAILURE;
+	}
+	return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
+} catch ( const std::exception & e ) {
+	std::cerr << "Error: " << e.what() << "\n";
+	return EXIT_FAILURE;
+}
@@ -1,9 +1,25 @@
 #pragma once
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <vector>
+#include <gsl/span>
 #include "error.h"
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__) \
+    || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define KAB_SWAR_DIGITS 1
+#else
+#define KAB_SWAR_DIGITS 0
+#endif
+
 namespace kab_advent {
 	template<typename T>
 	struct conversion_result {
@@ -11,16 +27,159 @@ namespace kab_advent {
 		char const* conversion_end;
 	};
 
-	inline auto to_int(std::string_view input) -> expected<conversion_result<int>> {
-		using namespace std::string_literals;
-		char* conversion_end = nullptr;
-		auto const str = std::string( input );
-		auto const token_value = std::strtol( str.c_str(), &conversion_end, 10 );
-		if ( conversion_end == str.c_str() ) {
-			return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "Invalid integer string \""s.append( str ).append( "\"" ) ) );
+	namespace detail {
+		inline auto is_digit( char const c ) noexcept -> bool {
+			return static_cast<unsigned char>( c - '0' ) < 10;
+		}
+
+		inline auto is_blank( char const c ) noexcept -> bool {
+			return c == ' ' || c == '\t' || c == '\r';
+		}
+
+		inline auto is_integer_start( char const c ) noexcept -> bool {
+			return is_digit( c ) || c == '-' || c == '+';
+		}
+
+#if KAB_SWAR_DIGITS
+		// Eight ASCII digits are checked and decoded as a single little-endian 64-bit word (SWAR)
+		inline auto load_eight_chars( char const* first ) noexcept -> std::uint64_t {
+			auto chunk = std::uint64_t();
+			std::memcpy( &chunk, first, sizeof( chunk ) );
+			return chunk;
 		}
 
-		auto const input_conversion_end = input.data() + std::distance( str.c_str(), static_cast<char const*>(conversion_end) );
-		return conversion_result<int>{ static_cast<int>( token_value ), input_conversion_end };
+		inline auto is_eight_digits( std::uint64_t const chunk ) noexcept -> bool {
+			return ( ( ( chunk & 0xF0F0F0F0F0F0F0F0 ) | ( ( ( chunk + 0x0606060606060606 ) & 0xF0F0F0F0F0F0F0F0 ) >> 4 ) ) == 0x3333333333333333 );
+		}
+
+		inline auto parse_eight_digits( std::uint64_t chunk ) noexcept -> std::uint64_t {
+			chunk -= 0x3030303030303030;
+			chunk = ( chunk * 10 ) + ( chunk >> 8 );
+			return ( ( ( chunk & 0x000000FF000000FF ) * ( 100 + ( 1000000ULL << 32 ) ) )
+				+ ( ( ( chunk >> 16 ) & 0x000000FF000000FF ) * ( 1 + ( 10000ULL << 32 ) ) ) ) >> 32;
+		}
+
+		// Long digit runs are decoded eight at a time, up to sixteen digits, then finished one digit at a time.
+		// Returns nullptr on overflow of the given magnitude limit
+		inline auto parse_long_digits( char const* first, char const* last, std::uint64_t const limit, std::uint64_t & value ) noexcept -> char const* {
+			value = parse_eight_digits( load_eight_chars( first ) );
+			first += 8;
+			if ( last - first >= 8 ) {
+				auto const chunk = load_eight_chars( first );
+				if ( is_eight_digits( chunk ) ) {
+					value = value * 100000000 + parse_eight_digits( chunk );
+					first += 8;
+				}
+			}
+
+			for ( ; first != last && is_digit( *first ); ++first ) {
+				if ( value > ( limit - static_cast<std::uint64_t>( *first - '0' ) ) / 10 ) {
+					return nullptr;
+				}
+				value = value * 10 + static_cast<std::uint64_t>( *first - '0' );
+			}
+			return value <= limit ? first : nullptr;
+		}
+#endif
+
+		// Parses an integer with strtol's leading whitespace and sign rules, without allocating.
+		// On success, first is moved past the integer
+		template<typename IntegerT>
+		auto parse_integer( char const*& first, char const* last, IntegerT & value ) noexcept -> std::errc {
+			auto current = first;
+			while ( current != last && std::isspace( static_cast<unsigned char>( *current ) ) ) {
+				++current;
+			}
+			// A '+' must be followed by a digit, as strtol rejects "+-5"
+			if ( current != last && *current == '+' ) {
+				++current;
+				if ( current == last || !is_digit( *current ) ) {
+					return std::errc::invalid_argument;
+				}
+			}
+
+#if KAB_SWAR_DIGITS
+			auto const negative = std::is_signed<IntegerT>::value && current != last && *current == '-';
+			auto const digits = current + ( negative ? 1 : 0 );
+			if ( last - digits >= 8 && is_eight_digits( load_eight_chars( digits ) ) ) {
+				using unsigned_t = std::make_unsigned_t<IntegerT>;
+				auto const limit = static_cast<std::uint64_t>( std::numeric_limits<unsigned_t>::max() ) >> ( std::is_signed<IntegerT>::value ? 1 : 0 );
+				auto magnitude = std::uint64_t();
+				auto const end = parse_long_digits( digits, last, limit + ( negative ? 1 : 0 ), magnitude );
+				if ( end == nullptr ) {
+					return std::errc::result_out_of_range;
+				}
+				value = negative ? static_cast<IntegerT>( 0 - static_cast<unsigned_t>( magnitude ) ) : static_cast<IntegerT>( magnitude );
+				first = end;
+				return std::errc();
+			}
+#endif
+
+			auto const result = std::from_chars( current, last, value );
+			if ( result.ec == std::errc() ) {
+				first = result.ptr;
+			}
+			return result.ec;
+		}
+	}
+
+	template<typename IntegerT>
+	auto to_integer( std::string_view input ) -> expected<conversion_result<IntegerT>> {
+		auto conversion_end = input.data();
+		auto value = IntegerT();
+		auto const ec = detail::parse_integer( conversion_end, input.data() + input.size(), value );
+		if ( ec == std::errc::result_out_of_range ) {
+			return make_unexpected( error_info( std::make_error_code( ec ), "Integer out of range \"{}\"", input ) );
+		} else if ( ec != std::errc() ) {
+			return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "Invalid integer string \"{}\"", input ) );
+		}
+
+		return conversion_result<IntegerT>{ value, conversion_end };
+	}
+
+	inline auto to_int( std::string_view input ) -> expected<conversion_result<int>> {
+		return to_integer<int>( input );
+	}
+
+	// Decodes a run of integers into the caller's buffer, stopping at the first token that is not an integer
+	// or when the buffer is full. Integers are separated by any run of blanks and delimiter characters.
+	// Returns the number of integers decoded and the end of the last one
+	template<typename IntegerT>
+	auto to_ints( std::string_view input, gsl::span<IntegerT> out, char const delimiter = ',' ) noexcept -> conversion_result<std::size_t> {
+		auto current = input.data();
+		auto const last = input.data() + input.size();
+		auto conversion_end = current;
+		auto count = std::size_t{ 0 };
+		while ( count < static_cast<std::size_t>( out.size() ) ) {
+			while ( current != last && ( detail::is_blank( *current ) || *current == delimiter ) ) {
+				++current;
+			}
+			if ( current == last || !detail::is_integer_start( *current ) || detail::parse_integer( current, last, out[count] ) != std::errc() ) {
+				break;
+			}
+			conversion_end = current;
+			++count;
+		}
+		return conversion_result<std::size_t>{ count, conversion_end };
+	}
+
+	// Appends a run of integers to a vector, decoding them directly into its storage
+	template<typename IntegerT, typename AllocatorT>
+	auto append_ints( std::string_view input, std::vector<IntegerT, AllocatorT> & out, char const delimiter = ',' ) -> char const* {
+		auto conversion_end = input.data();
+		while ( true ) {
+			auto const offset = out.size();
+			auto const chunk_size = std::max<std::size_t>( 16, offset );
+			out.resize( offset + chunk_size );
+			auto const decoded = to_ints( input, gsl::span<IntegerT>( out.data() + offset, static_cast<std::ptrdiff_t>( chunk_size ) ), delimiter );
+			out.resize( offset + decoded.data );
+			if ( decoded.data != 0 ) {
+				conversion_end = decoded.conversion_end;
+				input.remove_prefix( static_cast<std::size_t>( conversion_end - input.data() ) );
+			}
+			if ( decoded.data < chunk_size ) {
+				return conversion_end;
+			}
+		}
 	}
-}
\ No newline at end of file
+}
@@ -4,7 +4,6 @@
 #include <cctype>
 #include <cassert>
 #include <cmath>
-#include <set>
 #include <regex>
 #include <variant>
 #include <map>
@@ -14,12 +13,18 @@
 #include <cstdint>
 
 #include "algorithm.h"
+#include "arena.h"
 #include "error.h"
 #include "conversion.h"
+#include "parallel_parse.h"
+#include "parse_cache.h"
 #include "parser.h"
 #include "knot_hash.h"
 #include "disjoint_set.h"
-#include <fstream>
+#include "interner.h"
+#include "kab_advent.h"
+#include "solver.h"
+#include <climits>
 
 #if defined(_MSC_VER)
 #define UNREACHABLE() __assume(0)
@@ -32,27 +37,12 @@ namespace kab_advent {
         using namespace std::literals;
 
         namespace day1 {
-            auto input(gsl::span<std::string_view const> args) -> expected<std::string> {
-                auto input = std::string();
-                if(args.size() == 0) {
-                    if(!std::getline(std::cin, input)) {
-                        return expected<std::string>{ unexpect,
-                            error_info(std::make_error_code(std::errc::invalid_argument), "Could not read input") };
-                    }
-                } else if(args[0] == "--input") {
-                    if(args.size() < 2) {
-                        return expected<std::string>{ unexpect,
-                            error_info(std::make_error_code(std::errc::invalid_argument), "Missing input after --input") };
-                    }
-                    input = args[1];
-                } else {
-                    return expected<std::string>{ unexpect,
-                        error_info(std::make_error_code(std::errc::invalid_argument), "Invalid parameter \""s.append(args[0]).append("\"")) };
-                }
+            auto parse_captcha(std::string_view text) -> expected<std::string_view> {
+                auto const input = right_trim(text);
                 if(!std::all_of(input.begin(), input.end(),
                                 [] (const char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
-                    return expected<std::string>{ unexpect,
-                        error_info(std::make_error_code(std::errc::invalid_argument), "Input \""s.append(input).append("\" was not numerical")) };
+                    return expected<std::string_view>{ unexpect,
+                        error_info(std::make_error_code(std::errc::invalid_argument), "Input \"{}\" was not numerical", input) };
                 }
 
                 return input;
@@ -87,30 +77,6 @@ namespace kab_advent {
             auto part2(std::string_view captcha) -> int {
                 return part(captcha, gsl::narrow<int>(captcha.size() / 2));
             }
-
-            auto solve(gsl::span<std::string_view const> args) -> int {
-                if(args.size() < 1) {
-                    throw std::runtime_error("Missing part parameter");
-                }
-                auto const part = args[0];
-                args = args.subspan(1);
-
-                auto const captcha = input(args);
-                if(!captcha) {
-                    std::cerr << captcha.error() << "\n";
-                    return EXIT_FAILURE;
-                }
-
-                if(part == "1") {
-                    std::cout << part1(captcha.value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else if(part == "2") {
-                    std::cout << part2(captcha.value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else {
-                    throw std::runtime_error{"Parameter \""s.append(part).append("\" was not a valid part (try 1 or 2)")};
-                }
-            }
         }
 
         namespace day2 {
@@ -118,77 +84,26 @@ namespace kab_advent {
             using input_t = std::vector<row_t>;
             using input_view_t = gsl::span<row_t const>;
 
-            auto do_input(std::string_view arg) -> expected<input_t> {
+            auto parse_matrix_rows(std::string_view arg) -> expected<input_t> {
                 auto input = input_t();
-                auto row = row_t();
-
-                while(arg.size() > 0) {
-                    auto const itSeparator = std::find_if(arg.begin(), arg.end(), [] (char c) {
-                        return c == '\t' || c == '\n';
-                    });
-                    if(itSeparator == arg.end()) {
-                        if(row.size() > 0) {
-                            input.push_back(std::move(row));
-                        }
-                        return input;
-                    } else if(*itSeparator == '\t') {
-                        auto const token_size = static_cast<std::string_view::size_type>(std::distance(arg.begin(), itSeparator));
-                        auto const token_value = to_int(arg.substr(token_size));
-                        if(!token_value) {
-                            return expected<input_t>(unexpect, token_value.error());
-                        }
-                        row.push_back(token_value.value().data);
-                        arg = arg.substr(token_size + 1);
-                    } else if(*itSeparator == '\n') {
-                        auto const token_size = static_cast<std::string_view::size_type>(std::distance(arg.begin(), itSeparator));
-                        auto const token_value = to_int(arg.substr(token_size));
-                        if(!token_value) {
-                            return expected<input_t>(unexpect, token_value.error());
-                        }
-                        row.push_back(token_value.value().data);
+                auto lines = line_scanner(arg);
+                while(!lines.empty()) {
+                    auto const line = lines.consume_line();
+                    auto row = row_t();
+                    auto const row_end = append_ints(line, row, '\t');
+                    if(!left_trim(line.substr(std::distance(line.data(), row_end))).empty()) {
+                        return expected<input_t>{ unexpect,
+                            error_info(std::make_error_code(std::errc::invalid_argument), "Invalid integer row \"{}\"", line) };
+                    }
+                    if(row.size() > 0) {
                         input.push_back(std::move(row));
-                        row.clear();
-                        arg = arg.substr(token_size + 1);
                     }
                 }
                 return input;
             }
 
-            auto input(gsl::span<std::string_view const> args) -> expected<input_t> {
-                if(args.size() == 0) {
-                    return expected<input_t>{ unexpect,
-                        error_info(std::make_error_code(std::errc::invalid_argument), "No stdin support in this puzzle") };
-                } else if(args[0] == "--input") {
-                    if(args.size() < 2) {
-                        return expected<input_t>{ unexpect,
-                            error_info(std::make_error_code(std::errc::invalid_argument), "Missing input after --input") };
-                    }
-
-                    return do_input(args[1]);
-                } else if(args[0] == "--file") {
-                    if(args.size() < 2) {
-                        return expected<input_t>{ unexpect,
-                            error_info(std::make_error_code(std::errc::invalid_argument), "Missing filename after --input") };
-                    }
-
-                    auto const filepath = args[1];
-                    auto file = std::ifstream(std::string(filepath));
-                    if(!file) {
-                        return expected<input_t>{ unexpect,
-                            error_info(std::make_error_code(std::errc::invalid_argument), "File \""s.append(filepath).append("\" could not be opened")) };
-                    }
-
-                    auto arg = std::string();
-                    auto line = std::string();
-                    while(std::getline(file, line)) {
-                        arg.append(std::move(line)).append("\n");
-                    }
-
-                    return do_input(arg);
-                } else {
-                    return expected<input_t>{ unexpect,
-                        error_info(std::make_error_code(std::errc::invalid_argument), "Invalid parameter \""s.append(args[0]).append("\"")) };
-                }
+            auto parse_matrix(std::string_view text) -> expected<input_t> {
+                return concatenate_chunks(parse_line_chunks(text, parse_matrix_rows));
             }
 
             auto part1(input_view_t matrix) -> int {
@@ -223,75 +138,13 @@ namespace kab_advent {
 
                 return std::accumulate(dividends.begin(), dividends.end(), 0);
             }
-
-            auto solve(gsl::span<std::string_view const> args) -> int {
-                if(args.size() < 1) {
-                    throw std::runtime_error("Missing part parameter");
-                }
-                auto const part = args[0];
-                args = args.subspan(1);
-
-                auto const matrix = input(args);
-                if(!matrix) {
-                    std::cerr << matrix.error() << "\n";
-                    return EXIT_FAILURE;
-                }
-
-                if(part == "1") {
-                    std::cout << part1(matrix.value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else if(part == "2") {
-                    std::cout << part2(matrix.value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else {
-                    throw std::runtime_error{"Parameter \""s.append(part).append("\" was not a valid part (try 1 or 2)")};
-                }
-            }
         }
 
         namespace day3 {
             using input_t = int;
 
-            auto input(gsl::span<std::string_view const> args) -> expected<input_t> {
-                if(args.size() == 0) {
-                    auto input = input_t();
-                    if(!std::cin >> input) {
-                        return expected<input_t>{ unexpect,
-                            error_info(std::make_error_code(std::errc::invalid_argument), "Could not parse input to an integer") };
-                    }
-
-                    return input;
-                } else if(args[0] == "--input") {
-                    if(args.size() < 2) {
-                        return expected<input_t>{ unexpect,
-                            error_info(std::make_error_code(std::errc::invalid_argument), "Missing input after --input") };
-                    }
-
-                    return to_int(args[1]).map(&conversion_result<int>::data);
-                } else if(args[0] == "--file") {
-                    if(args.size() < 2) {
-                        return expected<input_t>{ unexpect,
-                            error_info(std::make_error_code(std::errc::invalid_argument), "Missing filename after --input") };
-                    }
-
-                    auto const filepath = args[1];
-                    auto file = std::ifstream(std::string(filepath));
-                    if(!file) {
-                        return expected<input_t>{ unexpect,
-                            error_info(std::make_error_code(std::errc::invalid_argument), "File \""s.append(filepath).append("\" could not be opened")) };
-                    }
-
-                    auto input = input_t();
-                    if(!(file >> input)) {
-                        return expected<input_t>{ unexpect,
-                            error_info(std::make_error_code(std::errc::invalid_argument), "Could not parse input to an integer") };
-                    }
-
-                    return input;
-                } else {
-                    return expected<input_t>{ unexpect,
-                        error_info(std::make_error_code(std::errc::invalid_argument), "Invalid parameter \""s.append(args[0]).append("\"")) };
-                }
+            auto parse_square(std::string_view text) -> expected<input_t> {
+                return to_int(text).map(&conversion_result<int>::data);
             }
 
             auto part1(input_t n) -> int {
@@ -340,205 +193,83 @@ namespace kab_advent {
                 (void)input;
                 throw std::runtime_error("Part2 not implemented");
             }
-
-            auto solve(gsl::span<std::string_view const> args) -> int {
-                if(args.size() < 1) {
-                    throw std::runtime_error("Missing part parameter");
-                }
-                auto const part = args[0];
-                args = args.subspan(1);
-
-                auto const in = input(args);
-                if(!in) {
-                    std::cerr << in.error() << "\n";
-                    return EXIT_FAILURE;
-                }
-
-                if(part == "1") {
-                    std::cout << part1(in.value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else if(part == "2") {
-                    std::cout << part2(in.value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else {
-                    throw std::runtime_error{"Parameter \""s.append(part).append("\" was not a valid part (try 1 or 2)")};
-                }
-            }
         }
 
         namespace day4 {
-            auto input(gsl::span<std::string_view const> args) -> expected<std::string> {
-                if(args.size() == 0) {
-                    auto input = std::string();
-                    if(!std::getline(std::cin, input)) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Could not parse input to an integer"));
-                    }
-
-                    return input;
-                } else if(args[0] == "--input") {
-                    if(args.size() < 2) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing input after --input"));
-                    }
-
-                    return std::string(args[1]);
-                } else if(args[0] == "--file") {
-                    if(args.size() < 2) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing filename after --input"));
-                    }
-
-                    auto const filepath = args[1];
-                    auto file = std::ifstream(std::string(filepath));
-                    if(!file) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "File \""s.append(filepath).append("\" could not be opened")));
-                    }
-
-                    auto input = std::string();
-                    auto line = std::string();
-                    while(std::getline(file, line)) {
-                        if(!line.empty()) {
-                            input.append(line).append("\n");
-                        }
-                    }
-
-                    return input;
-                } else {
-                    return make_unexpected(
-                        error_info(std::make_error_code(std::errc::invalid_argument), "Invalid parameter \""s.append(args[0]).append("\""))
-                    );
-                }
+            auto parse_passphrases(std::string_view text) -> expected<std::string_view> {
+                return text;
             }
 
-            auto part1(std::string_view s) -> int {
+            // Counts the non-empty lines whose words are all accepted, in a single pass over the spaces and newlines
+            // of the text. Every space ends a word, so repeated spaces make empty words, but an empty last word is
+            // ignored. reset_line is called before each new line
+            template<typename AcceptWordT, typename ResetLineT>
+            auto count_valid_passphrases(std::string_view const text, AcceptWordT accept_word, ResetLineT reset_line) -> int {
                 auto validLineCount = 0;
-                for(auto lineEnd = std::find(s.begin(), s.end(), '\n')
-                    ; !s.empty() && lineEnd != s.end()
-                    ; s.remove_prefix(std::distance(s.begin(), lineEnd) + 1)
-                    , lineEnd = std::find(s.begin(), s.end(), '\n')) {
-                    auto line = std::string_view(s.data(), std::distance(s.begin(), lineEnd));
-                    auto foundTokens = std::set<std::string_view>();
-                    for(auto tokenEnd = std::find(line.begin(), line.end(), ' ')
-                        ; !line.empty()
-                        ; (tokenEnd != line.end()) ? line.remove_prefix(std::distance(line.begin(), tokenEnd) + 1) : line = std::string_view()
-                        , tokenEnd = std::find(line.begin(), line.end(), ' ')) {
-                        auto const token = std::string_view(line.data(), std::distance(line.begin(), tokenEnd));
-                        if(foundTokens.count(token) == 1) {
-                            break;
+                auto delimiters = delimiter_scanner(text, " \n");
+                auto lineBegin = std::size_t{0};
+                auto wordBegin = std::size_t{0};
+                auto valid = true;
+                while(lineBegin < text.size()) {
+                    auto const wordEnd = std::min(delimiters.next(), text.size());
+                    auto const endsLine = wordEnd == text.size() || text[wordEnd] == '\n';
+                    if(valid && (!endsLine || wordEnd != wordBegin)) {
+                        valid = accept_word(text.substr(wordBegin, wordEnd - wordBegin));
+                    }
+                    wordBegin = wordEnd + 1;
+                    if(endsLine) {
+                        if(valid && wordEnd != lineBegin) {
+                            ++validLineCount;
                         }
-                        foundTokens.insert(token);
-                    }
-                    if(line.empty()) {
-                        ++validLineCount;
+                        reset_line();
+                        valid = true;
+                        lineBegin = wordBegin;
                     }
                 }
 
                 return validLineCount;
             }
 
+            // Passphrases are independent, so large inputs are counted in chunks of lines on parallel threads
+            auto part1(std::string_view s) -> int {
+                auto const counts = parse_line_chunks(s, [] (std::string_view const chunk) {
+                    // Sized so that the words of a typical passphrase fit the table's inline slots
+                    auto foundTokens = flat_hash_set<std::string_view, string_hash, std::equal_to<>, 32>();
+                    return count_valid_passphrases(chunk, [&foundTokens] (std::string_view const token) {
+                        return foundTokens.insert(token).second;
+                    }, [&foundTokens] {
+                        foundTokens.clear();
+                    });
+                });
+                return std::accumulate(counts.begin(), counts.end(), 0);
+            }
+
             auto part2(std::string_view s) -> int {
-                auto validLineCount = 0;
-                for(auto lineEnd = std::find(s.begin(), s.end(), '\n')
-                    ; !s.empty() && lineEnd != s.end()
-                    ; s.remove_prefix(std::distance(s.begin(), lineEnd) + 1)
-                    , lineEnd = std::find(s.begin(), s.end(), '\n')) {
-                    auto line = std::string_view(s.data(), std::distance(s.begin(), lineEnd));
+                auto const counts = parse_line_chunks(s, [] (std::string_view const chunk) {
                     auto foundTokens = std::vector<std::string_view>();
-                    for(auto tokenEnd = std::find(line.begin(), line.end(), ' ')
-                        ; !line.empty()
-                        ; (tokenEnd != line.end()) ? line.remove_prefix(std::distance(line.begin(), tokenEnd) + 1) : line = std::string_view()
-                        , tokenEnd = std::find(line.begin(), line.end(), ' ')) {
-                        auto const token = std::string_view(line.data(), std::distance(line.begin(), tokenEnd));
+                    return count_valid_passphrases(chunk, [&foundTokens] (std::string_view const token) {
                         if(std::any_of(foundTokens.begin(), foundTokens.end(), [token] (std::string_view const foundToken) {
                             return std::is_permutation(foundToken.begin(), foundToken.end(), token.begin(), token.end());
                         })) {
-                            break;
+                            return false;
                         }
                         foundTokens.push_back(token);
-                    }
-                    if(line.empty()) {
-                        ++validLineCount;
-                    }
-                }
-
-                return validLineCount;
-            }
-
-            auto solve(gsl::span<std::string_view const> args) -> int {
-                if(args.size() < 1) {
-                    throw std::runtime_error("Missing part parameter");
-                }
-                auto const part = args[0];
-                args = args.subspan(1);
-
-                auto const in = input(args);
-                if(!in) {
-                    std::cerr << in.error() << "\n";
-                    return EXIT_FAILURE;
-                }
-
-                if(part == "1") {
-                    std::cout << part1(in.value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else if(part == "2") {
-                    std::cout << part2(in.value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else {
-                    throw std::runtime_error{"Parameter \""s.append(part).append("\" was not a valid part (try 1 or 2)")};
-                }
+                        return true;
+                    }, [&foundTokens] {
+                        foundTokens.clear();
+                    });
+                });
+                return std::accumulate(counts.begin(), counts.end(), 0);
             }
         }
 
         namespace day5 {
-            auto input_impl(std::string_view arg) -> expected<std::vector<int>> {
+            auto parse_maze(std::string_view arg) -> expected<std::vector<int>> {
                 auto input = std::vector<int>();
-                while(auto const convert_result = to_int(arg)) {
-                    auto const& convert_value = convert_result.value();
-                    input.push_back(convert_value.data);
-                    arg = arg.substr(std::distance(arg.data(), convert_value.conversion_end));
-                }
+                append_ints(arg, input, '\n');
                 return input;
             }
 
-            auto input(gsl::span<std::string_view const> args) -> expected<std::vector<int>> {
-                if(args.size() == 0) {
-                    auto line = std::string();
-                    if(!std::getline(std::cin, line)) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Could not parse input to an integer"));
-                    }
-
-                    return input_impl(line);
-                } else if(args[0] == "--input") {
-                    if(args.size() < 2) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing input after --input"));
-                    }
-
-                    return input_impl(args[1]);
-                } else if(args[0] == "--file") {
-                    if(args.size() < 2) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing filename after --input"));
-                    }
-
-                    auto const filepath = args[1];
-                    auto file = std::ifstream(std::string(filepath));
-                    if(!file) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "File \""s.append(filepath).append("\" could not be opened")));
-                    }
-
-                    auto input = std::string();
-                    auto line = std::string();
-                    while(std::getline(file, line)) {
-                        if(!line.empty()) {
-                            input.append(line).append("\n");
-                        }
-                    }
-
-                    return input_impl(input);
-                } else {
-                    return make_unexpected(
-                        error_info(std::make_error_code(std::errc::invalid_argument), "Invalid parameter \""s.append(args[0]).append("\""))
-                    );
-                }
-            }
-
             auto part1(gsl::span<int const> input) -> int {
                 auto maze = std::vector<int>(input.begin(), input.end());
                 auto maze_position = maze.begin();
@@ -581,84 +312,15 @@ namespace kab_advent {
                 }
                 return step_count;
             }
-
-            auto solve(gsl::span<std::string_view const> args) -> int {
-                if(args.size() < 1) {
-                    throw std::runtime_error("Missing part parameter");
-                }
-                auto const part = args[0];
-                args = args.subspan(1);
-
-                auto const in = input(args);
-                if(!in) {
-                    std::cerr << in.error() << "\n";
-                    return EXIT_FAILURE;
-                }
-
-                if(part == "1") {
-                    std::cout << part1(in.value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else if(part == "2") {
-                    std::cout << part2(in.value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else {
-                    throw std::runtime_error{"Parameter \""s.append(part).append("\" was not a valid part (try 1 or 2)")};
-                }
-            }
         }
 
         namespace day6 {
-            auto input_impl(std::string_view arg) -> expected<std::vector<int>> {
+            auto parse_banks(std::string_view arg) -> expected<std::vector<int>> {
                 auto input = std::vector<int>();
-                while(auto const convert_result = to_int(arg)) {
-                    auto const& convert_value = convert_result.value();
-                    input.push_back(convert_value.data);
-                    arg = arg.substr(std::distance(arg.data(), convert_value.conversion_end));
-                }
+                append_ints(arg, input, '\t');
                 return input;
             }
 
-            auto input(gsl::span< std::string_view const > args) -> expected<std::vector<int>> {
-                if(args.size() == 0) {
-                    auto line = std::string();
-                    if(!std::getline(std::cin, line)) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Could not parse input to an integer"));
-                    }
-
-                    return input_impl(line);
-                } else if(args[0] == "--input") {
-                    if(args.size() < 2) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing input after --input"));
-                    }
-
-                    return input_impl(args[1]);
-                } else if(args[0] == "--file") {
-                    if(args.size() < 2) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing filename after --input"));
-                    }
-
-                    auto const filepath = args[1];
-                    auto file = std::ifstream(std::string(filepath));
-                    if(!file) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "File \""s.append(filepath).append("\" could not be opened")));
-                    }
-
-                    auto input = std::string();
-                    auto line = std::string();
-                    while(std::getline(file, line)) {
-                        if(!line.empty()) {
-                            input.append(line).append("\n");
-                        }
-                    }
-
-                    return input_impl(input);
-                } else {
-                    return make_unexpected(
-                        error_info(std::make_error_code(std::errc::invalid_argument), "Invalid parameter \""s.append(args[0]).append("\""))
-                    );
-                }
-            }
-
             struct redistribution_sentinel {
 
             };
@@ -760,140 +422,196 @@ namespace kab_advent {
 
                 return cycle_count - std::get<cycle_index>(*found_state);
             }
+        }
 
-            auto solve(gsl::span<std::string_view const> args) -> int {
-                if(args.size() < 1) {
-                    throw std::runtime_error("Missing part parameter");
-                }
-                auto const part = args[0];
-                args = args.subspan(1);
+        namespace day7 {
+            struct tower {
+                int weight;  // -1 until the tower's own line has been parsed
+                std::pmr::vector<int> dependencies;
+            };
 
-                auto const in = input(args);
-                if(!in) {
-                    std::cerr << in.error() << "\n";
-                    return EXIT_FAILURE;
+            // Towers are indexed by the interned id of their name
+            struct tower_graph {
+                explicit tower_graph(std::pmr::memory_resource * memory)
+                    : names(memory)
+                    , towers(memory) {
                 }
 
-                if(part == "1") {
-                    std::cout << part1(in.value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else if(part == "2") {
-                    std::cout << part2(in.value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else {
-                    throw std::runtime_error{"Parameter \""s.append(part).append("\" was not a valid part (try 1 or 2)")};
+                auto tower_at(int const id) -> tower & {
+                    while(towers.size() <= static_cast<std::size_t>(id)) {
+                        towers.push_back(tower{-1, std::pmr::vector<int>(towers.get_allocator().resource())});
+                    }
+                    return towers[static_cast<std::size_t>(id)];
                 }
-            }
-        }
 
-        namespace day7 {
-            struct tower {
-                std::string name;
-                int weight;
-                std::vector<std::string> dependencies;
+                string_interner names;
+                std::pmr::vector<tower> towers;
             };
 
-            using input_t = std::vector<tower>;
-
-            auto to_tower(std::string_view line) -> expected<tower> {
-                std::cmatch m;
-                if(!std::regex_match(line.data(), line.data() + line.size(), m, std::regex(R"(([a-z]+) \(([0-9]+)\)( -> (.*))?)"))) {
-                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "\""s.append(line).append("\" did not match the expected format")));
-                }
-                tower t;
-                t.name = m[1];
-                t.weight = std::stoi(m[2]);
-                if(m[4].matched) {
-                    auto const child_list = m[4].str();
-                    auto const child_pattern = std::regex(R"(([[:lower:]]+)(, )?)");
-                    auto child_iterator = std::sregex_iterator(child_list.begin(), child_list.end(), child_pattern);
-                    auto const child_sentinel = std::sregex_iterator();
-                    std::transform(child_iterator, child_sentinel, std::back_inserter(t.dependencies), [] (std::smatch const& s) {
-                        return s[1];
-                    });
-                }
-                return t;
+            using input_t = arena_owned<tower_graph>;
+
+            auto consume_name(std::string_view & line) -> std::string_view {
+                auto const name_end = std::find_if(line.begin(), line.end(), [] (char const c) { return c < 'a' || c > 'z'; });
+                auto const name = line.substr(0, std::distance(line.begin(), name_end));
+                line.remove_prefix(name.size());
+                return name;
             }
 
-            auto input(gsl::span<std::string_view const> args) -> expected<input_t> {
-                if(args.size() == 0) {
-                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Stdin input not supported for this day"));
-                } else if(args[0] == "--input") {
-                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "--input not supported for this day"));
-                } else if(args[0] == "--file") {
-                    if(args.size() < 2) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing filename after --input"));
+            // Parses "name (weight)" optionally followed by " -> child, child, ..." into the graph, returning the tower's id
+            auto parse_tower(std::string_view const line, tower_graph & graph) -> expected<int> {
+                auto const format_error = [line] {
+                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "\"{}\" did not match the expected format", line));
+                };
+
+                auto rest = right_trim(line);
+                auto const name = consume_name(rest);
+                if(name.empty() || !consume_char(rest, ' ') || !consume_char(rest, '(') || rest.empty() || !std::isdigit(static_cast<unsigned char>(rest.front()))) {
+                    return format_error();
+                }
+
+                auto const weight = to_int(rest);
+                if(!weight) {
+                    return make_unexpected(weight.error());
+                }
+                rest.remove_prefix(static_cast<std::size_t>(std::distance(rest.data(), weight.value().conversion_end)));
+                if(!consume_char(rest, ')')) {
+                    return format_error();
+                }
+
+                auto const id = graph.names.intern(name);
+                auto & t = graph.tower_at(id);
+                if(t.weight != -1) {
+                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Tower \"{}\" is listed twice", name));
+                }
+                t.weight = weight.value().data;
+
+                if(rest.empty()) {
+                    return id;
+                } else if(!begins_with(rest, " -> ")) {
+                    return format_error();
+                }
+                rest.remove_prefix(4);
+
+                do {
+                    auto const child = consume_name(rest);
+                    if(child.empty()) {
+                        return format_error();
+                    }
+                    auto const child_id = graph.names.intern(child);
+                    graph.tower_at(child_id);
+                    // Growing the tower list may have moved this tower
+                    graph.towers[static_cast<std::size_t>(id)].dependencies.push_back(child_id);
+                } while(consume_char(rest, ',') && consume_char(rest, ' '));
+
+                if(!rest.empty()) {
+                    return format_error();
+                }
+                return id;
+            }
+
+            template<typename Lines>
+            auto read_tower_lines(Lines & lines, input_t input) -> expected<input_t> {
+                while(!lines.empty()) {
+                    auto const line = lines.consume_line();
+                    if(!line.empty()) {
+                        auto const tower = parse_tower(line, *input);
+                        if(!tower) {
+                            return make_unexpected(tower.error());
+                        }
                     }
+                }
+                return input;
+            }
 
-                    auto const filepath = args[1];
-                    auto file = std::ifstream(std::string(filepath));
-                    if(!file) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "File \""s.append(filepath).append("\" could not be opened")));
+            // Joins the graphs parsed from consecutive chunks of the text. Towers are renumbered in the order the
+            // whole text first names them, so the ids match those of a parse on one thread
+            auto join_tower_chunks(std::vector<expected<input_t>> chunks) -> expected<input_t> {
+                for(auto const& chunk : chunks) {
+                    if(!chunk) {
+                        return make_unexpected(chunk.error());
                     }
+                }
+                if(chunks.size() == 1) {
+                    return std::move(chunks.front());
+                }
 
-                    auto input = input_t();
-                    auto line = std::string();
-                    while(std::getline(file, line)) {
-                        if(!line.empty()) {
-                            auto const tower = to_tower(line);
-                            if(!tower) {
-                                return make_unexpected(tower.error());
-                            }
-                            input.push_back(std::move(tower).value());
+                auto input = input_t();
+                auto ids = std::vector<int>();
+                for(auto const& chunk : chunks) {
+                    auto const& part = *chunk.value();
+                    ids.resize(part.names.size());
+                    for(std::size_t id = 0; id < ids.size(); ++id) {
+                        ids[id] = input->names.intern(part.names.name(static_cast<int>(id)));
+                        input->tower_at(ids[id]);
+                    }
+                    for(std::size_t id = 0; id < ids.size(); ++id) {
+                        auto const& t = part.towers[id];
+                        if(t.weight == -1) {
+                            continue;
+                        }
+                        auto & joined = input->towers[static_cast<std::size_t>(ids[id])];
+                        if(joined.weight != -1) {
+                            return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument),
+                                "Tower \"{}\" is listed twice", part.names.name(static_cast<int>(id))));
+                        }
+                        joined.weight = t.weight;
+                        for(auto const dependency : t.dependencies) {
+                            joined.dependencies.push_back(ids[static_cast<std::size_t>(dependency)]);
                         }
                     }
-
-                    return input;
-                } else {
-                    return make_unexpected(
-                        error_info(std::make_error_code(std::errc::invalid_argument), "Invalid parameter \""s.append(args[0]).append("\""))
-                    );
                 }
+                return input;
             }
 
-            auto part1(input_t input) -> std::string {
-                auto const find_top = [&input]
-                (std::string_view name) {
-                    return std::find_if(input.begin(), input.end(), [name] (tower const& t) { return std::find(t.dependencies.begin(), t.dependencies.end(), name) != t.dependencies.end(); });
-                };
-
-                auto found_bottom_tower = std::find_if(input.begin(), input.end(), [] (tower const& t) { return t.dependencies.size() > 0; });
-                assert(found_bottom_tower != input.end());
-                while(true) {
-                    auto const& current_tower = *found_bottom_tower;
-                    found_bottom_tower = find_top(current_tower.name);
-                    if(found_bottom_tower == input.end()) {
-                        return current_tower.name;
+            // Every tower must be listed, including those only seen held up by another one
+            auto check_towers(expected<input_t> input) -> expected<input_t> {
+                if(!input) {
+                    return input;
+                }
+                auto const& graph = *input.value();
+                if(graph.towers.empty()) {
+                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "No towers in input"));
+                }
+                for(std::size_t id = 0; id < graph.towers.size(); ++id) {
+                    if(graph.towers[id].weight == -1) {
+                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument),
+                            "Tower \"{}\" is held up but never listed", graph.names.name(static_cast<int>(id))));
                     }
                 }
+                return input;
             }
 
-            auto part2(input_t) -> int {
-                throw std::runtime_error("Not implemented");
+            auto parse_towers(std::string_view text) -> expected<input_t> {
+                return check_towers(join_tower_chunks(parse_line_chunks(text, [] (std::string_view const chunk) {
+                    auto lines = line_scanner(chunk);
+                    return read_tower_lines(lines, input_t());
+                })));
             }
 
-            auto solve(gsl::span<std::string_view const> args) -> int {
-                if(args.size() < 1) {
-                    throw std::runtime_error("Missing part parameter");
-                }
-                auto const part = args[0];
-                args = args.subspan(1);
+            auto stream_towers(stream_line_scanner & lines) -> expected<input_t> {
+                auto input = input_t();
+                input->names.keep_copies();
+                return check_towers(read_tower_lines(lines, std::move(input)));
+            }
 
-                auto const in = input(args);
-                if(!in) {
-                    std::cerr << in.error() << "\n";
-                    return EXIT_FAILURE;
+            auto part1(input_t const& input) -> std::string {
+                auto const& graph = *input;
+                auto held = std::vector<bool>(graph.towers.size());
+                for(auto const& t : graph.towers) {
+                    for(auto const dependency : t.dependencies) {
+                        held[static_cast<std::size_t>(dependency)] = true;
+                    }
                 }
 
-                if(part == "1") {
-                    std::cout << part1(std::move(in).value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else if(part == "2") {
-                    std::cout << part2(std::move(in).value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else {
-                    throw std::runtime_error{"Parameter \""s.append(part).append("\" was not a valid part (try 1 or 2)")};
+                auto const bottom = std::find(held.begin(), held.end(), false);
+                if(bottom == held.end()) {
+                    throw std::runtime_error("Every tower is held up by another one");
                 }
+                return std::string(graph.names.name(static_cast<int>(std::distance(held.begin(), bottom))));
+            }
+
+            auto part2(input_t const&) -> int {
+                throw std::runtime_error("Not implemented");
             }
         }
 
@@ -916,25 +634,36 @@ namespace kab_advent {
             }
 
             struct comparison_expression {
-                std::string register_name;
+                int register_id;
                 comparison_operator comp;
                 int value;
             };
 
             struct instruction {
-                std::string register_name;
+                int register_id;
                 arithmetic_operator op;
                 int operand;
                 comparison_expression expr;
             };
 
-            using input_t = std::vector<instruction>;
+            // Registers are referred to by the interned id of their name
+            struct program {
+                explicit program(std::pmr::memory_resource * memory)
+                    : registers(memory)
+                    , instructions(memory) {
+                }
+
+                string_interner registers;
+                std::pmr::vector<instruction> instructions;
+            };
+
+            using input_t = arena_owned<program>;
 
             auto find_end_token(std::string_view line) -> std::string_view::iterator {
                 return std::find_if(line.begin(), line.end(), [] (char const c) { return std::isspace(c); });
             }
 
-            auto parse_register(std::string_view instruction) -> expected<parsed_value<std::string>> {
+            auto parse_register(std::string_view instruction) -> expected<parsed_value<std::string_view>> {
                 auto const end_token = find_end_token(instruction);
                 auto const token = std::string_view(instruction.data(), std::distance(instruction.begin(), end_token));
                 if(token.empty()) {
@@ -942,7 +671,7 @@ namespace kab_advent {
                 }
 
                 auto const rest_tokens = end_token != instruction.end() ? instruction.substr(std::distance(instruction.begin(), end_token) + 1) : std::string_view{};
-                return parsed_value<std::string>{std::string(token), rest_tokens};
+                return parsed_value<std::string_view>{token, rest_tokens};
             }
 
             auto parse_arithmetic_operator(std::string_view instruction) -> expected<parsed_value<arithmetic_operator>> {
@@ -958,7 +687,7 @@ namespace kab_advent {
                 } else if(token == "dec") {
                     return parsed_value<arithmetic_operator>{arithmetic_operator::dec, rest_tokens};
                 } else {
-                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Expected arithmetic operator, but was \""s.append(token).append("\"")));
+                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Expected arithmetic operator, but was \"{}\"", token));
                 }
             }
 
@@ -994,11 +723,11 @@ namespace kab_advent {
                 } else if(token == ">=") {
                     return parsed_value<comparison_operator>{comparison_operator::greater_equal, rest_tokens};
                 } else {
-                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Expected comparison operator, but was \""s.append(token).append("\"")));
+                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Expected comparison operator, but was \"{}\"", token));
                 }
             }
 
-            auto parse_comparison(std::string_view line) -> expected<parsed_value<comparison_expression>> {
+            auto parse_comparison(std::string_view line, string_interner & registers) -> expected<parsed_value<comparison_expression>> {
                 auto const register_result = parse_register(line);
                 if(!register_result) {
                     return make_unexpected(register_result.error());
@@ -1015,7 +744,7 @@ namespace kab_advent {
                 }
 
                 return parsed_value<comparison_expression>{
-                    comparison_expression{register_result.value().value, op_result.value().value, value_result.value().value},
+                    comparison_expression{registers.intern(register_result.value().value), op_result.value().value, value_result.value().value},
                         value_result.value().rest_instruction
                 };
             }
@@ -1029,13 +758,13 @@ namespace kab_advent {
                 auto const rest_tokens = end_token != line.end() ? line.substr(std::distance(line.begin(), end_token) + 1) : std::string_view{};
 
                 if(token != "if") {
-                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Expected \"if\", but was \""s.append(token).append("\"")));
+                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Expected \"if\", but was \"{}\"", token));
                 }
 
                 return parsed_value<std::monostate>{ {}, rest_tokens};
             }
 
-            auto parse_instruction(std::string_view line) -> expected<instruction> {
+            auto parse_instruction(std::string_view line, string_interner & registers) -> expected<instruction> {
                 auto const register_result = parse_register(line);
                 if(!register_result) {
                     return make_unexpected(register_result.error());
@@ -1056,60 +785,136 @@ namespace kab_advent {
                     return make_unexpected(if_result.error());
                 }
 
-                auto const condition_result = parse_comparison(if_result.value().rest_instruction);
+                auto const condition_result = parse_comparison(if_result.value().rest_instruction, registers);
                 if(!condition_result) {
                     return make_unexpected(condition_result.error());
                 }
 
-                return instruction{register_result.value().value, op_result.value().value, value_result.value().value, condition_result.value().value};
+                return instruction{registers.intern(register_result.value().value), op_result.value().value, value_result.value().value, condition_result.value().value};
             }
 
-            auto input(gsl::span<std::string_view const> args) -> expected<input_t> {
-                if(args.size() == 0) {
-                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Stdin input not supported for this day"));
-                } else if(args[0] == "--input") {
-                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "--input not supported for this day"));
-                } else if(args[0] == "--file") {
-                    if(args.size() < 2) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing filename after --input"));
+            template<typename Lines>
+            auto parse_instruction_lines(Lines & lines, input_t input) -> expected<input_t> {
+                while(!lines.empty()) {
+                    auto const line = lines.consume_line();
+                    if(!line.empty()) {
+                        auto const instruction = parse_instruction(line, input->registers);
+                        if(!instruction) {
+                            return make_unexpected(instruction.error());
+                        }
+                        input->instructions.push_back(instruction.value());
                     }
+                }
 
-                    auto const filepath = args[1];
-                    auto file = std::ifstream(std::string(filepath));
-                    if(!file) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "File \""s.append(filepath).append("\" could not be opened")));
+                return input;
+            }
+
+            // Joins the programs parsed from consecutive chunks of the text, renumbering their registers in the order
+            // the whole text first names them
+            auto join_instruction_chunks(std::vector<expected<input_t>> chunks) -> expected<input_t> {
+                auto instruction_count = std::size_t{0};
+                for(auto const& chunk : chunks) {
+                    if(!chunk) {
+                        return make_unexpected(chunk.error());
                     }
+                    instruction_count += chunk.value()->instructions.size();
+                }
+                if(chunks.size() == 1) {
+                    return std::move(chunks.front());
+                }
 
-                    auto input = input_t();
-                    auto line = std::string();
-                    while(std::getline(file, line)) {
-                        if(!line.empty()) {
-                            auto const instruction = parse_instruction(line);
-                            if(!instruction) {
-                                return make_unexpected(instruction.error());
-                            }
-                            input.push_back(std::move(instruction).value());
-                        }
+                auto input = input_t();
+                input->instructions.reserve(instruction_count);
+                auto ids = std::vector<int>();
+                for(auto const& chunk : chunks) {
+                    auto const& part = *chunk.value();
+                    ids.resize(part.registers.size());
+                    for(std::size_t id = 0; id < ids.size(); ++id) {
+                        ids[id] = input->registers.intern(part.registers.name(static_cast<int>(id)));
+                    }
+                    for(auto i : part.instructions) {
+                        i.register_id = ids[static_cast<std::size_t>(i.register_id)];
+                        i.expr.register_id = ids[static_cast<std::size_t>(i.expr.register_id)];
+                        input->instructions.push_back(i);
                     }
+                }
+                return input;
+            }
 
-                    return input;
-                } else {
-                    return make_unexpected(
-                        error_info(std::make_error_code(std::errc::invalid_argument), "Invalid parameter \""s.append(args[0]).append("\""))
-                    );
+            auto parse_instructions(std::string_view text) -> expected<input_t> {
+                return join_instruction_chunks(parse_line_chunks(text, [] (std::string_view const chunk) {
+                    auto lines = line_scanner(chunk);
+                    return parse_instruction_lines(lines, input_t());
+                }));
+            }
+
+            auto stream_instructions(stream_line_scanner & lines) -> expected<input_t> {
+                auto input = input_t();
+                input->registers.keep_copies();
+                return parse_instruction_lines(lines, std::move(input));
+            }
+
+            void save_instructions(input_t const& in, binary_writer & out) {
+                out.write(static_cast<std::uint64_t>(in->registers.size()));
+                for(std::size_t id = 0; id < in->registers.size(); ++id) {
+                    out.write_string(in->registers.name(static_cast<int>(id)));
+                }
+                out.write_array(gsl::span<instruction const>(in->instructions.data(), in->instructions.size()));
+            }
+
+            auto load_instructions(binary_reader & bytes) -> expected<input_t> {
+                auto in = input_t();
+                // The cache entry is unmapped once loaded
+                in->registers.keep_copies();
+                auto register_count = std::size_t{0};
+                if(!bytes.read_count(sizeof(std::uint64_t), register_count)) {
+                    return make_unexpected(truncated_cache_entry());
+                }
+                for(std::size_t id = 0; id < register_count; ++id) {
+                    auto name = std::string_view();
+                    if(!bytes.read_string(name)) {
+                        return make_unexpected(truncated_cache_entry());
+                    }
+                    in->registers.intern(name);
                 }
+
+                auto instruction_count = std::size_t{0};
+                if(!bytes.read_count(sizeof(instruction), instruction_count)) {
+                    return make_unexpected(truncated_cache_entry());
+                }
+                in->instructions.resize(instruction_count);
+                bytes.read_elements(in->instructions.data(), instruction_count);
+
+                auto const is_register = [&in] (int const id) { return id >= 0 && static_cast<std::size_t>(id) < in->registers.size(); };
+                if(!std::all_of(in->instructions.begin(), in->instructions.end(), [is_register] (instruction const& i) {
+                    return is_register(i.register_id) && is_register(i.expr.register_id);
+                })) {
+                    return make_unexpected(error_info(std::make_error_code(std::errc::illegal_byte_sequence), "Parse cache entry refers to an unknown register"));
+                }
+                // Operators are copied as raw bytes, and any value outside their enumerators would reach UNREACHABLE
+                auto const is_operator = [] (instruction const& i) {
+                    auto const op = static_cast<int>(i.op);
+                    auto const comp = static_cast<int>(i.expr.comp);
+                    return op >= static_cast<int>(arithmetic_operator::inc) && op <= static_cast<int>(arithmetic_operator::dec)
+                        && comp >= static_cast<int>(comparison_operator::equal) && comp <= static_cast<int>(comparison_operator::greater_equal);
+                };
+                if(!std::all_of(in->instructions.begin(), in->instructions.end(), is_operator)) {
+                    return make_unexpected(error_info(std::make_error_code(std::errc::illegal_byte_sequence), "Parse cache entry holds an unknown operator"));
+                }
+                return in;
             }
 
-            auto part1(input_t in) -> int {
-                auto register_state = std::map<std::string_view, int>();
+            auto part1(input_t const& in) -> int {
+                auto register_state = std::vector<int>(in->registers.size());
 
-                for(instruction const& instruction : in) {
+                for(instruction const& instruction : in->instructions) {
                     auto const& condition = instruction.expr;
-                    if(operator_compare(condition.comp, register_state[condition.register_name], condition.value)) {
+                    if(operator_compare(condition.comp, register_state[static_cast<std::size_t>(condition.register_id)], condition.value)) {
+                        auto & state = register_state[static_cast<std::size_t>(instruction.register_id)];
                         if(instruction.op == arithmetic_operator::inc) {
-                            register_state[instruction.register_name] += instruction.operand;
+                            state += instruction.operand;
                         } else if(instruction.op == arithmetic_operator::dec) {
-                            register_state[instruction.register_name] -= instruction.operand;
+                            state -= instruction.operand;
                         } else {
                             assert(false && "Invalid operator");
                             UNREACHABLE();
@@ -1117,17 +922,17 @@ namespace kab_advent {
                     }
                 }
 
-                return std::max_element(register_state.begin(), register_state.end(), [] (auto const& lhs, auto const& rhs) { return lhs.second < rhs.second; })->second;
+                return register_state.empty() ? 0 : *std::max_element(register_state.begin(), register_state.end());
             }
 
-            auto part2(input_t in) -> int {
-                auto register_state = std::map<std::string_view, int>();
+            auto part2(input_t const& in) -> int {
+                auto register_state = std::vector<int>(in->registers.size());
                 auto max_value = INT_MIN;
 
-                for(instruction const& instruction : in) {
+                for(instruction const& instruction : in->instructions) {
                     auto const& condition = instruction.expr;
-                    if(operator_compare(condition.comp, register_state[condition.register_name], condition.value)) {
-                        auto & state = register_state[instruction.register_name];
+                    if(operator_compare(condition.comp, register_state[static_cast<std::size_t>(condition.register_id)], condition.value)) {
+                        auto & state = register_state[static_cast<std::size_t>(instruction.register_id)];
                         if(instruction.op == arithmetic_operator::inc) {
                             state += instruction.operand;
                         } else if(instruction.op == arithmetic_operator::dec) {
@@ -1143,42 +948,20 @@ namespace kab_advent {
 
                 return max_value;
             }
-
-            auto solve(gsl::span<std::string_view const> args) -> int {
-                if(args.size() < 1) {
-                    throw std::runtime_error("Missing part parameter");
-                }
-                auto const part = args[0];
-                args = args.subspan(1);
-
-                auto const in = input(args);
-                if(!in) {
-                    std::cerr << in.error() << "\n";
-                    return EXIT_FAILURE;
-                }
-
-                if(part == "1") {
-                    std::cout << part1(std::move(in).value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else if(part == "2") {
-                    std::cout << part2(std::move(in).value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else {
-                    throw std::runtime_error{"Parameter \""s.append(part).append("\" was not a valid part (try 1 or 2)")};
-                }
-            }
         }
-
         namespace day9 {
             struct garbage {
                 int count;
             };
 
-            struct group {
-                std::vector<std::variant<group, garbage>> things;
+            // Groups only ever nest inside each other, so the stream is scanned with a depth counter instead of
+            // being built into a tree, and arbitrarily deep inputs cannot run out of stack
+            struct stream_totals {
+                std::int64_t score;
+                std::int64_t garbage;
             };
 
-            using input_t = group;
+            using input_t = stream_totals;
 
             auto peek_group_begin(std::string_view line) -> bool {
                 return !line.empty() && line.front() == '{';
@@ -1192,7 +975,9 @@ namespace kab_advent {
                 return !line.empty() && line.front() == '<';
             }
 
-            auto parse_group(std::string_view line) -> expected<parsed_value<group>>;
+            auto peek_group_delimiter(std::string_view line) -> bool {
+                return !line.empty() && line.front() == ',';
+            }
 
             auto parse_garbage(std::string_view line) -> expected<parsed_value<garbage>> {
                 if(!peek_garbage_begin(line)) {
@@ -1224,243 +1009,78 @@ namespace kab_advent {
                 return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Garbage did not start end with '>'"));
             }
 
-            auto parse_thing(std::string_view line) -> expected<parsed_value<std::variant<group, garbage>>> {
-                auto const to_parsed_value = [] (auto&& value) -> parsed_value<std::variant<group, garbage>> {
-                    auto const rest_instruction = value.rest_instruction;
-                    return parsed_value<std::variant<group, garbage>>{ std::variant<group, garbage>(std::forward<decltype(value)>(value).value), rest_instruction };
-                };
-
-                if(peek_group_begin(line)) {
-                    return parse_group(line).map(to_parsed_value);
-                } else if(peek_garbage_begin(line)) {
-                    return parse_garbage(line).map(to_parsed_value);
-                } else {
-                    if(line.empty()) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "No character found while parsing thing" ));
-                    } else {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Character '"s.append(line.substr(1, 1)).append("' not a valid thing start")));
-                    }
-                }
-            }
-
-            auto peek_group_delimiter(std::string_view line) -> bool {
-                return !line.empty() && line.front() == ',';
-            }
-
-            auto parse_group(std::string_view line) -> expected<parsed_value<group>> {
+            // Every group scores its depth, the outermost one scoring 1
+            auto parse_stream(std::string_view line) -> expected<input_t> {
                 if(!peek_group_begin(line)) {
                     return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Group did not start with '{'"));
                 }
-                line.remove_prefix(1);
-
-                if(peek_group_end(line)) {
-                    line.remove_prefix(1);
-                    return parsed_value<group>{ group{}, line };
-                }
 
-                group g;
-                bool first_token = true;
-                while(first_token || peek_group_delimiter(line))
-                {
-                    if(!std::exchange(first_token, false)) {
+                auto totals = input_t{0, 0};
+                auto depth = std::int64_t{0};
+                for(;;) {
+                    // A thing is expected here: the outermost group, the first thing of a group or one after a ','
+                    if(peek_group_begin(line)) {
                         line.remove_prefix(1);
-                    }
-
-                    auto thing_result = parse_thing(line);
-                    if(!thing_result) {
-                        return make_unexpected(thing_result.error());
-                    }
-                    
-                    line = thing_result.value().rest_instruction;
-                    g.things.push_back(std::move(thing_result.value().value));
-                }
-
-                if(!peek_group_end(line)) {
-                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Group did not end with '}'"));
-                }
-                line.remove_prefix(1);
-
-                return parsed_value<group>{ g, line };
-            }
-
-            auto input(gsl::span<std::string_view const> args) -> expected<input_t> {
-                if(args.size() == 0) {
-                    auto line = std::string();
-                    if(!std::getline(std::cin, line)) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Could not parse input to an integer"));
-                    }
-
-                    return parse_group(line).map(&parsed_value<group>::value);
-                } else if(args[0] == "--input") {
-                    if(args.size() < 2) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing input after --input"));
-                    }
-
-                    return parse_group(args[1]).map(&parsed_value<group>::value);
-                } else if(args[0] == "--file") {
-                    if(args.size() < 2) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing filename after --input"));
-                    }
-
-                    auto const filepath = args[1];
-                    auto file = std::ifstream(std::string(filepath));
-                    if(!file) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "File \""s.append(filepath).append("\" could not be opened")));
-                    }
-
-                    auto input = std::string();
-                    auto line = std::string();
-                    while(std::getline(file, line)) {
-                        if(!line.empty()) {
-                            input.append(line).append("\n");
+                        ++depth;
+                        totals.score += depth;
+                        if(!peek_group_end(line)) {
+                            continue;
                         }
+                    } else if(peek_garbage_begin(line)) {
+                        auto const garbage_result = parse_garbage(line);
+                        if(!garbage_result) {
+                            return make_unexpected(garbage_result.error());
+                        }
+                        totals.garbage += garbage_result.value().value.count;
+                        line = garbage_result.value().rest_instruction;
+                    } else if(line.empty()) {
+                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "No character found while parsing thing"));
+                    } else {
+                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Character '{}' not a valid thing start", line.substr(0, 1)));
                     }
 
-                    return parse_group(input).map(&parsed_value<group>::value);
-                } else {
-                    return make_unexpected(
-                        error_info(std::make_error_code(std::errc::invalid_argument), "Invalid parameter \""s.append(args[0]).append("\""))
-                    );
-                }
-            }
-
-            auto get_score(group const& g, int score_depth) -> int {
-                auto total_score = score_depth;
-                for(auto const& thing : g.things) {
-                    if(std::holds_alternative<group>(thing)) {
-                        total_score += get_score(std::get<group>(thing), score_depth + 1);
-                    }
-                }
-
-                return total_score;
-            }
-
-            auto part1(input_t in) -> int {
-                return get_score(in, 1);
-            }
-
-            auto get_garbage(group const& g) -> int {
-                auto total_garbage = 0;
-                for(auto const& thing : g.things) {
-                    if(std::holds_alternative<group>(thing)) {
-                        total_garbage += get_garbage(std::get<group>(thing));
-                    } else {
-                        total_garbage += std::get<garbage>(thing).count;
+                    // After a thing, its group either goes on with another one or ends, possibly closing outer groups
+                    while(!peek_group_delimiter(line)) {
+                        if(!peek_group_end(line)) {
+                            return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Group did not end with '}'"));
+                        }
+                        line.remove_prefix(1);
+                        if(--depth == 0) {
+                            return totals;
+                        }
                     }
+                    line.remove_prefix(1);
                 }
-
-                return total_garbage;
             }
 
-            auto part2(input_t in) -> int {
-                return get_garbage(in);
+            auto part1(input_t const& in) -> std::int64_t {
+                return in.score;
             }
 
-            auto solve(gsl::span<std::string_view const> args) -> int {
-                if(args.size() < 1) {
-                    throw std::runtime_error("Missing part parameter");
-                }
-                auto const part = args[0];
-                args = args.subspan(1);
-
-                auto const in = input(args);
-                if(!in) {
-                    std::cerr << in.error() << "\n";
-                    return EXIT_FAILURE;
-                }
-
-                if(part == "1") {
-                    std::cout << part1(std::move(in).value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else if(part == "2") {
-                    std::cout << part2(std::move(in).value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else {
-                    throw std::runtime_error{"Parameter \""s.append(part).append("\" was not a valid part (try 1 or 2)")};
-                }
+            auto part2(input_t const& in) -> std::int64_t {
+                return in.garbage;
             }
         }
 
         namespace day10 {
-            using input_t = std::string;
-
-            auto input(gsl::span<std::string_view const> args) -> expected<input_t> {
-                if(args.size() == 0) {
-                    auto line = std::string();
-                    if(!std::getline(std::cin, line)) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Could not parse input to a string"));
-                    }
-
-                    return line;
-                } else if(args[0] == "--input") {
-                    if(args.size() < 2) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing input after --input"));
-                    }
-
-                    return std::string(args[1]);
-                } else if(args[0] == "--file") {
-                    if(args.size() < 2) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing filename after --input"));
-                    }
 
-                    auto const filepath = args[1];
-                    auto file = std::ifstream(std::string(filepath));
-                    if(!file) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "File \""s.append(filepath).append("\" could not be opened")));
-                    }
-
-                    auto input = std::string();
-                    auto line = std::string();
-                    while(std::getline(file, line)) {
-                        if(!line.empty()) {
-                            input.append(line).append("\n");
-                        }
-                    }
-
-                    return input;
-                } else {
-                    return make_unexpected(
-                        error_info(std::make_error_code(std::errc::invalid_argument), "Invalid parameter \""s.append(args[0]).append("\""))
-                    );
-                }
-            }
-
-            auto peek_delimiter(std::string_view line) -> bool {
-                return !line.empty() && line.front() == ',';
-            }
-
-            auto strip_delimiter(std::string_view & line) -> bool {
-                if(peek_delimiter(line)) {
-                    line.remove_prefix(1);
-                    return true;
-                }
-                return false;
-            }
-
-            auto parse_integer(std::string_view line) -> expected<parsed_value<int>> {
-                return to_int(line).map([line] (conversion_result<int> c) -> parsed_value<int> {
-                    return parsed_value<int>{c.data, line.substr(std::distance(line.data(), c.conversion_end))};
-                });
+            auto parse_lengths(std::string_view text) -> expected<std::string_view> {
+                return right_trim(text);
             }
 
             auto parse_integer_list(std::string_view line) -> expected<std::vector<int>> {
                 auto input = std::vector<int>();
-                do {
-                    auto integer_result = parse_integer(line);
-                    if(!integer_result) {
-                        return make_unexpected(integer_result.error());
-                    }
-
-                    input.push_back(integer_result.value().value);
-                    line = integer_result.value().rest_instruction;
-                } while(strip_delimiter(line));
+                auto const rest = line.substr(std::distance(line.data(), append_ints(line, input)));
+                if(input.empty() || !left_trim(rest).empty()) {
+                    return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Invalid integer list \"{}\"", line));
+                }
                 return input;
             }
 
-            auto part1(input_t input) -> int {
+            auto part1(std::string_view input) -> int {
                 auto parse_result = parse_integer_list(input);
                 if(!parse_result) {
-                    throw std::system_error(parse_result.error().get_error_code(), std::string(parse_result.error().get_error_message()));
+                    throw std::system_error(parse_result.error().get_error_code(), parse_result.error().get_error_message());
                 }
 
                 auto const skip_list = parse_result.value();
@@ -1477,7 +1097,7 @@ namespace kab_advent {
                 return list[0] * list[1];
             }
 
-            auto part2(input_t input) -> std::string {
+            auto part2(std::string_view input) -> std::string {
                 auto skip_list = std::vector<int>(input.begin(), input.end());
                 auto const end_sequence = {17, 31, 73, 47, 23};
                 skip_list.insert(skip_list.end(), end_sequence.begin(), end_sequence.end());
@@ -1508,30 +1128,6 @@ namespace kab_advent {
 
                 return output;
             }
-
-            auto solve(gsl::span<std::string_view const> args) -> int {
-                if(args.size() < 1) {
-                    throw std::runtime_error("Missing part parameter");
-                }
-                auto const part = args[0];
-                args = args.subspan(1);
-
-                auto const in = input(args);
-                if(!in) {
-                    std::cerr << in.error() << "\n";
-                    return EXIT_FAILURE;
-                }
-
-                if(part == "1") {
-                    std::cout << part1(std::move(in).value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else if(part == "2") {
-                    std::cout << part2(std::move(in).value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else {
-                    throw std::runtime_error{"Parameter \""s.append(part).append("\" was not a valid part (try 1 or 2)")};
-                }
-            }
         }
 
 
@@ -1588,47 +1184,6 @@ namespace kab_advent {
 				return input;
 			}
 
-			auto input(gsl::span<std::string_view const> args) -> expected<input_t> {
-				if ( args.size() == 0 ) {
-					auto line = std::string();
-					if ( !std::getline( std::cin, line ) ) {
-						return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "Could not parse input to a string" ) );
-					}
-
-					return parse_direction_sequence(line);
-				} else if ( args[0] == "--input" ) {
-					if ( args.size() < 2 ) {
-						return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "Missing input after --input" ) );
-					}
-
-					return parse_direction_sequence( args[1] );
-				} else if ( args[0] == "--file" ) {
-					if ( args.size() < 2 ) {
-						return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "Missing filename after --input" ) );
-					}
-
-					auto const filepath = args[1];
-					auto file = std::ifstream( std::string( filepath ) );
-					if ( !file ) {
-						return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "File \""s.append( filepath ).append( "\" could not be opened" ) ) );
-					}
-
-					auto input = std::string();
-					auto line = std::string();
-					while ( std::getline( file, line ) ) {
-						if ( !line.empty() ) {
-							input.append( line ).append( "\n" );
-						}
-					}
-
-					return parse_direction_sequence(input);
-				} else {
-					return make_unexpected(
-						error_info( std::make_error_code( std::errc::invalid_argument ), "Invalid parameter \""s.append( args[0] ).append( "\"" ) )
-					);
-				}
-			}
-
 			struct cube_coord3d {
 				int x, y, z;
 
@@ -1669,39 +1224,15 @@ namespace kab_advent {
 				} );
 				return max_distance;
 			}
-
-			auto solve( gsl::span<std::string_view const> args ) {
-				if ( args.size() < 1 ) {
-					throw std::runtime_error( "Missing part parameter" );
-				}
-				auto const part = args[0];
-				args = args.subspan( 1 );
-
-				auto const in = input( args );
-				if ( !in ) {
-					std::cerr << in.error() << "\n";
-					return EXIT_FAILURE;
-				}
-
-				if ( part == "1" ) {
-					std::cout << part1( std::move( in ).value() ) << "\n";
-					return EXIT_SUCCESS;
-				} else if ( part == "2" ) {
-					std::cout << part2( std::move( in ).value() ) << "\n";
-					return EXIT_SUCCESS;
-				} else {
-					throw std::runtime_error { "Parameter \""s.append( part ).append( "\" was not a valid part (try 1 or 2)" ) };
-				}
-			}
 		}
 
 		namespace day12 {
 			struct program {
 				int id;
-				std::vector<int> links;
+				std::pmr::vector<int> links;
 			};
 
-			using input_t = std::vector<program>;
+			using input_t = arena_owned<std::pmr::vector<program>>;
 
 			auto consume_arrow( std::string_view & line ) -> bool {
 				line = left_trim( line );
@@ -1713,24 +1244,17 @@ namespace kab_advent {
 				}
 			}
 
-			auto parse_program_id_list( std::string_view line ) -> expected<parsed_value<std::vector<int>>> {
-				auto ids = std::vector<int>();
-				do {
-					line = left_trim( line );
-
-					auto const program_id_result = to_int( line );
-					if ( !program_id_result ) {
-						return make_unexpected( program_id_result.error() );
-					}
-
-					ids.push_back( program_id_result.value().data );
-					line = line.substr( std::distance( line.data(), program_id_result.value().conversion_end ) );
-				} while ( consume_delimiter( line ) );
+			auto parse_program_id_list( std::string_view line, std::pmr::memory_resource * memory ) -> expected<parsed_value<std::pmr::vector<int>>> {
+				auto ids = std::pmr::vector<int>( memory );
+				auto const ids_end = append_ints( line, ids );
+				if ( ids.empty() ) {
+					return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "Expected a list of program ids after \"<->\"" ) );
+				}
 
-				return parsed_value<std::vector<int>>{ ids, line };
+				return parsed_value<std::pmr::vector<int>>{ std::move( ids ), line.substr( std::distance( line.data(), ids_end ) ) };
 			}
 
-			auto parse_program( std::string_view line ) -> expected<parsed_value<program>> {
+			auto parse_program( std::string_view line, std::pmr::memory_resource * memory ) -> expected<parsed_value<program>> {
 				auto const program_id_result = to_int( line );
 				if ( !program_id_result ) {
 					return make_unexpected( program_id_result.error() );
@@ -1741,69 +1265,112 @@ namespace kab_advent {
 					return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "Expected \"<->\" after program id" ) );
 				}
 
-				auto const links_result = parse_program_id_list( left_trim( line ) );
+				auto links_result = parse_program_id_list( left_trim( line ), memory );
 				if ( !links_result ) {
 					return make_unexpected( links_result.error() );
 				}
 				line = links_result.value().rest_instruction;
 
-				return parsed_value<program>{ program { program_id_result.value().data, links_result.value().value }, line };
+				return parsed_value<program>{ program { program_id_result.value().data, std::move( links_result.value().value ) }, line };
 			}
 
-			auto parse_programs( std::string_view line ) -> expected<input_t> {
+			template<typename Lines>
+			auto parse_program_lines( Lines & lines ) -> expected<input_t> {
 				auto in = input_t();
-				do {
-					line = left_trim( line );
-					auto const program_result = parse_program( line );
+				while ( !lines.empty() ) {
+					auto const line = right_trim( left_trim( lines.consume_line() ) );
+					if ( line.empty() ) {
+						continue;
+					}
+
+					auto program_result = parse_program( line, in.resource() );
 					if ( !program_result ) {
 						return make_unexpected( program_result.error() );
 					}
+					if ( !right_trim( program_result.value().rest_instruction ).empty() ) {
+						return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "Unexpected \"{}\" after program links", program_result.value().rest_instruction ) );
+					}
+					in->push_back( std::move( program_result.value().value ) );
+				}
+				return in;
+			}
 
-					in.push_back( program_result.value().value );
-					line = program_result.value().rest_instruction;
-				} while ( consume_newline( line ) && !line.empty() );
+			auto check_programs( expected<input_t> in ) -> expected<input_t> {
+				if ( in && in.value()->empty() ) {
+					return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "No programs in input" ) );
+				}
 				return in;
 			}
 
-			auto input( gsl::span<std::string_view const> args ) -> expected<input_t> {
-				if ( args.size() == 0 ) {
-					return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "Stdin input not supported for this day" ) );
-				} else if ( args[0] == "--input" ) {
-					return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "--input not supported for this day" ) );
-				} else if ( args[0] == "--file" ) {
-					if ( args.size() < 2 ) {
-						return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "Missing filename after --input" ) );
+			// Joins the programs parsed from consecutive chunks of the text, copying their links into a single arena
+			auto join_program_chunks( std::vector<expected<input_t>> chunks ) -> expected<input_t> {
+				auto program_count = std::size_t{ 0 };
+				for ( auto const& chunk : chunks ) {
+					if ( !chunk ) {
+						return make_unexpected( chunk.error() );
 					}
+					program_count += chunk.value()->size();
+				}
+				if ( chunks.size() == 1 ) {
+					return std::move( chunks.front() );
+				}
 
-					auto const filepath = args[1];
-					auto file = std::ifstream( std::string( filepath ) );
-					if ( !file ) {
-						return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "File \""s.append( filepath ).append( "\" could not be opened" ) ) );
+				auto in = input_t();
+				in->reserve( program_count );
+				for ( auto const& chunk : chunks ) {
+					for ( auto const& p : *chunk.value() ) {
+						in->push_back( program{ p.id, std::pmr::vector<int>( p.links.begin(), p.links.end(), in.resource() ) } );
 					}
+				}
+				return in;
+			}
 
-					auto input = std::string();
-					auto line = std::string();
-					while ( std::getline( file, line ) ) {
-						if ( !line.empty() ) {
-							input.append( line ).append("\n");
-						}
+			auto parse_programs( std::string_view text ) -> expected<input_t> {
+				return check_programs( join_program_chunks( parse_line_chunks( text, [] ( std::string_view const chunk ) {
+					auto lines = line_scanner( chunk );
+					return parse_program_lines( lines );
+				} ) ) );
+			}
+
+			auto stream_programs( stream_line_scanner & lines ) -> expected<input_t> {
+				return check_programs( parse_program_lines( lines ) );
+			}
+
+			void save_programs( input_t const& in, binary_writer & out ) {
+				out.write( static_cast<std::uint64_t>( in->size() ) );
+				for ( auto const& p : *in ) {
+					out.write( p.id );
+					out.write_array( gsl::span<int const>( p.links.data(), p.links.size() ) );
+				}
+			}
+
+			auto load_programs( binary_reader & bytes ) -> expected<input_t> {
+				auto in = input_t();
+				auto program_count = std::size_t{ 0 };
+				if ( !bytes.read_count( sizeof( int ) + sizeof( std::uint64_t ), program_count ) ) {
+					return make_unexpected( truncated_cache_entry() );
+				}
+				in->reserve( program_count );
+				for ( std::size_t i = 0; i < program_count; ++i ) {
+					auto id = 0;
+					auto link_count = std::size_t{ 0 };
+					if ( !bytes.read( id ) || !bytes.read_count( sizeof( int ), link_count ) ) {
+						return make_unexpected( truncated_cache_entry() );
 					}
-					
-					return parse_programs(input);
-				} else {
-					return make_unexpected(
-						error_info( std::make_error_code( std::errc::invalid_argument ), "Invalid parameter \""s.append( args[0] ).append( "\"" ) )
-					);
+					auto links = std::pmr::vector<int>( link_count, in.resource() );
+					bytes.read_elements( links.data(), link_count );
+					in->push_back( program{ id, std::move( links ) } );
 				}
+				return in;
 			}
 
 			auto make_set( input_t const& in ) -> disjoint_set<int> {
 				auto s = disjoint_set<int>();
-				for ( auto const& e : in ) {
+				for ( auto const& e : *in ) {
 					s.add_element( e.id );
 				}
 
-				for ( auto const& e : in ) {
+				for ( auto const& e : *in ) {
 					for ( auto const& link : e.links ) {
 						s.unite( e.id, link );
 					}
@@ -1811,46 +1378,22 @@ namespace kab_advent {
 				return s;
 			}
 
-			auto part1( input_t in ) -> std::ptrdiff_t {
+			auto part1( input_t const& in ) -> std::ptrdiff_t {
 				auto s = make_set( in );
 
-				return std::count_if( in.begin(), in.end(), [&s, zero_root = s.find_root( in[0].id )]( program const& p ) -> bool { return s.find_root( p.id ) == zero_root; } );
+				return std::count_if( in->begin(), in->end(), [&s, zero_root = s.find_root( ( *in )[0].id )]( program const& p ) -> bool { return s.find_root( p.id ) == zero_root; } );
 			}
 
-			auto part2( input_t in ) -> size_t {
+			auto part2( input_t const& in ) -> size_t {
 				auto s = make_set( in );
 
-				auto group_ids = std::set<int>();
-				for ( auto const& e : in ) {
+				auto group_ids = flat_hash_set<int>();
+				for ( auto const& e : *in ) {
 					group_ids.emplace( s.find_root( e.id ) );
 				}
 
 				return group_ids.size();
 			}
-
-			auto solve( gsl::span<std::string_view const> args ) -> int {
-				if ( args.size() < 1 ) {
-					throw std::runtime_error( "Missing part parameter" );
-				}
-				auto const part = args[0];
-				args = args.subspan( 1 );
-
-				auto const in = input( args );
-				if ( !in ) {
-					std::cerr << in.error() << "\n";
-					return EXIT_FAILURE;
-				}
-
-				if ( part == "1" ) {
-					std::cout << part1( std::move( in ).value() ) << "\n";
-					return EXIT_SUCCESS;
-				} else if ( part == "2" ) {
-					std::cout << part2( std::move( in ).value() ) << "\n";
-					return EXIT_SUCCESS;
-				} else {
-					throw std::runtime_error { "Parameter \""s.append( part ).append( "\" was not a valid part (try 1 or 2)" ) };
-				}
-			}
 		}		
 		
 		namespace day13 {
@@ -1882,51 +1425,50 @@ namespace kab_advent {
 				return parsed_value<layer>{ layer { depth_result.value().data, range_result.value().data }, line };
 			}
 
-			auto parse_layers( std::string_view lines ) -> expected<input_t> {
+			template<typename Lines>
+			auto parse_layer_lines( Lines & lines ) -> expected<input_t> {
 				auto in = input_t();
-				do {
-					lines = left_trim( lines );
-					auto const program_result = parse_layer( lines );
-					if ( !program_result ) {
-						return make_unexpected( program_result.error() );
+				while ( !lines.empty() ) {
+					auto const line = right_trim( left_trim( lines.consume_line() ) );
+					if ( line.empty() ) {
+						continue;
 					}
 
-					in.push_back( program_result.value().value );
-					lines = program_result.value().rest_instruction;
-				} while ( consume_newline( lines ) && !lines.empty() );
+					auto const layer_result = parse_layer( line );
+					if ( !layer_result ) {
+						return make_unexpected( layer_result.error() );
+					}
+					if ( !right_trim( layer_result.value().rest_instruction ).empty() ) {
+						return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "Unexpected \"{}\" after layer range", layer_result.value().rest_instruction ) );
+					}
+					in.push_back( layer_result.value().value );
+				}
 				return in;
 			}
 
-			auto input( gsl::span<std::string_view const> args ) -> expected<input_t> {
-				if ( args.size() == 0 ) {
-					return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "Stdin input not supported for this day" ) );
-				} else if ( args[0] == "--input" ) {
-					return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "--input not supported for this day" ) );
-				} else if ( args[0] == "--file" ) {
-					if ( args.size() < 2 ) {
-						return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "Missing filename after --input" ) );
-					}
+			auto parse_layers( std::string_view text ) -> expected<input_t> {
+				return concatenate_chunks( parse_line_chunks( text, [] ( std::string_view const chunk ) {
+					auto lines = line_scanner( chunk );
+					return parse_layer_lines( lines );
+				} ) );
+			}
 
-					auto const filepath = args[1];
-					auto file = std::ifstream( std::string( filepath ) );
-					if ( !file ) {
-						return make_unexpected( error_info( std::make_error_code( std::errc::invalid_argument ), "File \""s.append( filepath ).append( "\" could not be opened" ) ) );
-					}
+			auto stream_layers( stream_line_scanner & lines ) -> expected<input_t> {
+				return parse_layer_lines( lines );
+			}
 
-					auto input = std::string();
-					auto line = std::string();
-					while ( std::getline( file, line ) ) {
-						if ( !line.empty() ) {
-							input.append( line ).append( "\n" );
-						}
-					}
+			void save_layers( input_t const& in, binary_writer & out ) {
+				out.write_array( gsl::span<layer const>( in ) );
+			}
 
-					return parse_layers( input );
-				} else {
-					return make_unexpected(
-						error_info( std::make_error_code( std::errc::invalid_argument ), "Invalid parameter \""s.append( args[0] ).append( "\"" ) )
-					);
+			auto load_layers( binary_reader & bytes ) -> expected<input_t> {
+				auto layer_count = std::size_t{ 0 };
+				if ( !bytes.read_count( sizeof( layer ), layer_count ) ) {
+					return make_unexpected( truncated_cache_entry() );
 				}
+				auto in = input_t( layer_count );
+				bytes.read_elements( in.data(), layer_count );
+				return in;
 			}
 
 			auto layer_position( layer const& l, int64_t t ) -> int {
@@ -1963,53 +1505,12 @@ namespace kab_advent {
 
 				throw std::runtime_error( "Couldn't find a solution before integer overflow" );
 			}
-
-			auto solve( gsl::span<std::string_view const> args ) -> int {
-				if ( args.size() < 1 ) {
-					throw std::runtime_error( "Missing part parameter" );
-				}
-				auto const part = args[0];
-				args = args.subspan( 1 );
-
-				auto const in = input( args );
-				if ( !in ) {
-					std::cerr << in.error() << "\n";
-					return EXIT_FAILURE;
-				}
-
-				if ( part == "1" ) {
-					std::cout << part1( std::move( in ).value() ) << "\n";
-					return EXIT_SUCCESS;
-				} else if ( part == "2" ) {
-					std::cout << part2( std::move( in ).value() ) << "\n";
-					return EXIT_SUCCESS;
-				} else {
-					throw std::runtime_error { "Parameter \""s.append( part ).append( "\" was not a valid part (try 1 or 2)" ) };
-				}
-			}
 		}
 		
 		namespace day14 {
-            using input_t = std::string;
-
-            auto input(gsl::span<std::string_view const> args) -> expected<input_t> {
-                auto input = std::string();
-                if(args.size() == 0) {
-                    if(!std::getline(std::cin, input)) {
-                        return expected<std::string>{ unexpect,
-                            error_info(std::make_error_code(std::errc::invalid_argument), "Could not read input") };
-                    }
-                } else if(args[0] == "--input") {
-                    if(args.size() < 2) {
-                        return expected<std::string>{ unexpect,
-                            error_info(std::make_error_code(std::errc::invalid_argument), "Missing input after --input") };
-                    }
-                    input = args[1];
-                } else {
-                    return expected<std::string>{ unexpect,
-                        error_info(std::make_error_code(std::errc::invalid_argument), "Invalid parameter \""s.append(args[0]).append("\"")) };
-                }
-                return input;
+
+            auto parse_key(std::string_view text) -> expected<std::string_view> {
+                return right_trim(text);
             }
 
             auto bit_count(std::string_view s) -> size_t {
@@ -2024,41 +1525,17 @@ namespace kab_advent {
                 return bits.count();
             }
 
-            auto part1(input_t in) -> int {
+            auto part1(std::string_view in) -> int {
                 auto const rows = make_iota_view(0, 128);
                 return std::accumulate(rows.begin(), rows.end(), 0, [in] ( int value, int i ) -> int {
-                    return value + static_cast<int>(bit_count(knot_hash(in + "-" + std::to_string(i))));
+                    return value + static_cast<int>(bit_count(knot_hash(std::string(in).append("-").append(std::to_string(i)))));
                 });
             }
 
-            auto part2(input_t in) -> int {
+            auto part2(std::string_view in) -> int {
                 (void)in;
                 throw std::runtime_error("Not implemented");
             }
-
-            auto solve(gsl::span<std::string_view const> args) -> int {
-                if(args.size() < 1) {
-                    throw std::runtime_error("Missing part parameter");
-                }
-                auto const part = args[0];
-                args = args.subspan(1);
-
-                auto const in = input(args);
-                if(!in) {
-                    std::cerr << in.error() << "\n";
-                    return EXIT_FAILURE;
-                }
-
-                if(part == "1") {
-                    std::cout << part1(std::move(in).value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else if(part == "2") {
-                    std::cout << part2(std::move(in).value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else {
-                    throw std::runtime_error{"Parameter \""s.append(part).append("\" was not a valid part (try 1 or 2)")};
-                }
-            }
         }
 
         namespace day15 {
@@ -2083,47 +1560,6 @@ namespace kab_advent {
                 return input_t{first_result.value().data, second_result.value().data};
             }
 
-            auto input(gsl::span<std::string_view const> args) -> expected<input_t> {
-                if(args.size() == 0) {
-                    auto line = std::string();
-                    if(!std::getline(std::cin, line)) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Could not parse input to a string"));
-                    }
-
-                    return parse_integer_pair(line);
-                } else if(args[0] == "--input") {
-                    if(args.size() < 2) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing input after --input"));
-                    }
-
-                    return parse_integer_pair(args[1]);
-                } else if(args[0] == "--file") {
-                    if(args.size() < 2) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing filename after --input"));
-                    }
-
-                    auto const filepath = args[1];
-                    auto file = std::ifstream(std::string(filepath));
-                    if(!file) {
-                        return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "File \""s.append(filepath).append("\" could not be opened")));
-                    }
-
-                    auto input = std::string();
-                    auto line = std::string();
-                    while(std::getline(file, line)) {
-                        if(!line.empty()) {
-                            input.append(line).append("\n");
-                        }
-                    }
-
-                    return parse_integer_pair(input);
-                } else {
-                    return make_unexpected(
-                        error_info(std::make_error_code(std::errc::invalid_argument), "Invalid parameter \""s.append(args[0]).append("\""))
-                    );
-                }
-            }
-
             auto constexpr generator_a_factor = 16807;
             auto constexpr generator_b_factor = 48271;
             auto constexpr remainder_factor = 2147483647;
@@ -2168,73 +1604,153 @@ namespace kab_advent {
                     return (generate_a() & generator_mask) == (generate_b() & generator_mask);
                 });
             }
+        }
 
-            auto solve(gsl::span<std::string_view const> args) -> int {
-                if(args.size() < 1) {
-                    throw std::runtime_error("Missing part parameter");
-                }
-                auto const part = args[0];
-                args = args.subspan(1);
+        template<auto Parse>
+        using parse_result_t = typename decltype(Parse(std::string_view()))::value_type;
 
-                auto const in = input(args);
-                if(!in) {
-                    std::cerr << in.error() << "\n";
-                    return EXIT_FAILURE;
-                }
+        template<auto Parse>
+        auto parse_input(std::string_view text) -> expected<parsed_input> {
+            auto in = Parse(text);
+            if(!in) {
+                return make_unexpected(in.error());
+            }
+            return parsed_input(std::make_shared<parse_result_t<Parse> const>(std::move(in).value()));
+        }
 
-                if(part == "1") {
-                    std::cout << part1(std::move(in).value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else if(part == "2") {
-                    std::cout << part2(std::move(in).value()) << "\n";
-                    return EXIT_SUCCESS;
-                } else {
-                    throw std::runtime_error{"Parameter \""s.append(part).append("\" was not a valid part (try 1 or 2)")};
-                }
+        template<auto Parse, auto Save>
+        void save_input(parsed_input const& in, std::string & out) {
+            auto writer = binary_writer(out);
+            Save(*std::static_pointer_cast<parse_result_t<Parse> const>(in), writer);
+        }
+
+        template<auto Load>
+        auto load_input(std::string_view bytes) -> expected<parsed_input> {
+            auto reader = binary_reader(bytes);
+            auto in = Load(reader);
+            if(!in) {
+                return make_unexpected(in.error());
+            }
+            if(!reader.empty()) {
+                return make_unexpected(error_info(std::make_error_code(std::errc::illegal_byte_sequence), "Trailing bytes in parse cache entry"));
+            }
+            return parsed_input(std::make_shared<typename decltype(in)::value_type const>(std::move(in).value()));
+        }
+
+        template<auto Parse, auto Part>
+        auto solve_part(parsed_input const& in) -> answer {
+            return make_answer(Part(*std::static_pointer_cast<parse_result_t<Parse> const>(in)));
+        }
+
+        template<auto Parse, auto Part>
+        constexpr auto make_solver(int day, int part, input_kind kind, bool supports_stdin, bool supports_inline) -> solver {
+            return {day, part, kind, supports_stdin, supports_inline, &parse_input<Parse>, nullptr, &solve_part<Parse, Part>, nullptr, nullptr};
+        }
+
+        // A solver whose parsed input can be stored in the parse cache. Load must rebuild exactly what Parse returns
+        template<auto Parse, auto Part, auto Save, auto Load>
+        constexpr auto make_cached_solver(int day, int part, input_kind kind, bool supports_stdin, bool supports_inline) -> solver {
+            static_assert(std::is_same_v<parse_result_t<Parse>, typename decltype(Load(std::declval<binary_reader &>()))::value_type>,
+                "Load must return the same input type as Parse");
+            return {day, part, kind, supports_stdin, supports_inline, &parse_input<Parse>, nullptr, &solve_part<Parse, Part>, &save_input<Parse, Save>, &load_input<Load>};
+        }
+
+        template<auto StreamParse>
+        auto parse_stream_input(std::istream & stream) -> expected<parsed_input> {
+            auto lines = stream_line_scanner(stream);
+            auto in = StreamParse(lines);
+            if(lines.failed()) {
+                return make_unexpected(error_info(std::make_error_code(std::errc::io_error), "Could not read input"));
             }
+            if(!in) {
+                return make_unexpected(in.error());
+            }
+            return parsed_input(std::make_shared<typename decltype(in)::value_type const>(std::move(in).value()));
+        }
+
+        // Lets a solver parse stdin while it arrives. StreamParse must build exactly what Parse does
+        template<auto Parse, auto StreamParse>
+        constexpr auto with_streaming(solver s) -> solver {
+            static_assert(std::is_same_v<parse_result_t<Parse>, typename decltype(StreamParse(std::declval<stream_line_scanner &>()))::value_type>,
+                "StreamParse must return the same input type as Parse");
+            s.parse_stream = &parse_stream_input<StreamParse>;
+            return s;
+        }
+
+        constexpr solver solver_table[] = {
+            make_solver<day1::parse_captcha, day1::part1>(1, 1, input_kind::line, true, true),
+            make_solver<day1::parse_captcha, day1::part2>(1, 2, input_kind::line, true, true),
+            make_solver<day2::parse_matrix, day2::part1>(2, 1, input_kind::lines, false, true),
+            make_solver<day2::parse_matrix, day2::part2>(2, 2, input_kind::lines, false, true),
+            make_solver<day3::parse_square, day3::part1>(3, 1, input_kind::line, true, true),
+            make_solver<day3::parse_square, day3::part2>(3, 2, input_kind::line, true, true),
+            make_solver<day4::parse_passphrases, day4::part1>(4, 1, input_kind::lines, true, true),
+            make_solver<day4::parse_passphrases, day4::part2>(4, 2, input_kind::lines, true, true),
+            make_solver<day5::parse_maze, day5::part1>(5, 1, input_kind::lines, true, true),
+            make_solver<day5::parse_maze, day5::part2>(5, 2, input_kind::lines, true, true),
+            make_solver<day6::parse_banks, day6::part1>(6, 1, input_kind::line, true, true),
+            make_solver<day6::parse_banks, day6::part2>(6, 2, input_kind::line, true, true),
+            with_streaming<day7::parse_towers, day7::stream_towers>(make_solver<day7::parse_towers, day7::part1>(7, 1, input_kind::lines, true, true)),
+            with_streaming<day7::parse_towers, day7::stream_towers>(make_solver<day7::parse_towers, day7::part2>(7, 2, input_kind::lines, true, true)),
+            with_streaming<day8::parse_instructions, day8::stream_instructions>(make_cached_solver<day8::parse_instructions, day8::part1, day8::save_instructions, day8::load_instructions>(8, 1, input_kind::lines, true, true)),
+            with_streaming<day8::parse_instructions, day8::stream_instructions>(make_cached_solver<day8::parse_instructions, day8::part2, day8::save_instructions, day8::load_instructions>(8, 2, input_kind::lines, true, true)),
+            make_solver<day9::parse_stream, day9::part1>(9, 1, input_kind::line, true, true),
+            make_solver<day9::parse_stream, day9::part2>(9, 2, input_kind::line, true, true),
+            make_solver<day10::parse_lengths, day10::part1>(10, 1, input_kind::line, true, true),
+            make_solver<day10::parse_lengths, day10::part2>(10, 2, input_kind::line, true, true),
+            make_solver<day11::parse_direction_sequence, day11::part1>(11, 1, input_kind::line, true, true),
+            make_solver<day11::parse_direction_sequence, day11::part2>(11, 2, input_kind::line, true, true),
+            with_streaming<day12::parse_programs, day12::stream_programs>(make_cached_solver<day12::parse_programs, day12::part1, day12::save_programs, day12::load_programs>(12, 1, input_kind::lines, true, true)),
+            with_streaming<day12::parse_programs, day12::stream_programs>(make_cached_solver<day12::parse_programs, day12::part2, day12::save_programs, day12::load_programs>(12, 2, input_kind::lines, true, true)),
+            with_streaming<day13::parse_layers, day13::stream_layers>(make_cached_solver<day13::parse_layers, day13::part1, day13::save_layers, day13::load_layers>(13, 1, input_kind::lines, true, true)),
+            with_streaming<day13::parse_layers, day13::stream_layers>(make_cached_solver<day13::parse_layers, day13::part2, day13::save_layers, day13::load_layers>(13, 2, input_kind::lines, true, true)),
+            make_solver<day14::parse_key, day14::part1>(14, 1, input_kind::line, true, true),
+            make_solver<day14::parse_key, day14::part2>(14, 2, input_kind::line, true, true),
+            make_solver<day15::parse_integer_pair, day15::part1>(15, 1, input_kind::line, true, true),
+            make_solver<day15::parse_integer_pair, day15::part2>(15, 2, input_kind::line, true, true),
+        };
+
+        template<std::size_t N>
+        constexpr auto is_indexed_by_day_and_part(solver const (&table)[N]) -> bool {
+            for(std::size_t i = 0; i < N; ++i) {
+                if(table[i].day != static_cast<int>(i / 2) + 1 || table[i].part != static_cast<int>(i % 2) + 1) {
+                    return false;
+                }
+            }
+            return true;
         }
 
+        static_assert(is_indexed_by_day_and_part(solver_table), "Solvers must list both parts of every day, ordered by day then part");
     }
 
-    auto day(gsl::span<std::string_view const> args) -> int {
-        if(args.size() < 1) {
-            throw std::runtime_error("Missing part parameter");
+    auto solvers() noexcept -> gsl::span<solver const> {
+        return solver_table;
+    }
+
+    auto find_solver(int day, int part) noexcept -> solver const* {
+        if(day < 1 || part < 1 || part > 2) {
+            return nullptr;
+        }
+
+        auto const index = static_cast<std::size_t>((day - 1) * 2 + (part - 1));
+        return index < std::size(solver_table) ? &solver_table[index] : nullptr;
+    }
+
+    auto solve(int day, int part, std::string_view input) -> expected<answer> {
+        auto const* const solver = find_solver(day, part);
+        if(solver == nullptr) {
+            return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Day {} is not implemented")
+                .append(day).append(" part ").append(part));
+        }
+
+        auto const parsed = solver->parse(input);
+        if(!parsed) {
+            return make_unexpected(parsed.error());
         }
-        auto const day = args[0];
-        args = args.subspan(1);
-
-        if(day == "1") {
-            return day1::solve(args);
-        } else if(day == "2") {
-            return day2::solve(args);
-        } else if(day == "3") {
-            return day3::solve(args);
-        } else if(day == "4") {
-            return day4::solve(args);
-        } else if(day == "5") {
-            return day5::solve(args);
-        } else if(day == "6") {
-            return day6::solve(args);
-        } else if(day == "7") {
-            return day7::solve(args);
-        } else if(day == "8") {
-            return day8::solve(args);
-        } else if(day == "9") {
-            return day9::solve(args);
-        } else if(day == "10") {
-            return day10::solve(args);
-        } else if ( day == "11" ) {
-			return day11::solve( args );
-		} else if ( day == "12" ) {
-			return day12::solve( args );
-		} else if ( day == "13" ) {
-			return day13::solve( args );
-		} else if(day == "14") {
-            return day14::solve(args);
-        } else if(day == "15") {
-            return day15::solve(args);
-        } else {
-            throw std::runtime_error{"Parameter \""s.append(day).append("\" was not a valid day (try 1-25)")};
+        try {
+            return solver->solve(parsed.value());
+        } catch(std::runtime_error const& e) {
+            return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "{}", e.what()));
         }
     }
-}
\ No newline at end of file
+}
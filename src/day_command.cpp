@@ -0,0 +1,97 @@
+#include "day.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "conversion.h"
+#include "error.h"
+#include "input.h"
+#include "profile.h"
+#include "result_cache.h"
+#include "result_writer.h"
+#include "solver.h"
+
+namespace kab_advent {
+    namespace {
+        using namespace std::literals;
+
+        auto parse_number(std::string_view arg) -> int {
+            auto const result = to_int(arg);
+            if(!result || result.value().conversion_end != arg.data() + arg.size()) {
+                return 0;
+            }
+            return result.value().data;
+        }
+
+        // In text format a single run prints its bare answer and reports errors on stderr. Other formats write a
+        // record on stdout either way
+        auto print_result(solver const& s, expected<answer> const& result, solve_stats const& stats) -> int {
+            auto const format = get_output_format();
+            if(!result && format == output_format::text) {
+                std::cerr << result.error() << "\n";
+                return EXIT_FAILURE;
+            }
+
+            auto const scope = profile::scoped_phase(profile::phase::output);
+            auto writer = result_writer(std::cout, format);
+            if(format == output_format::text) {
+                writer.write_answer(result.value());
+            } else {
+                writer.write(s.day, s.part, result, &stats);
+            }
+            return result ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    auto day(gsl::span<std::string_view const> args) -> int {
+        if(args.size() < 1) {
+            throw std::runtime_error("Missing day parameter");
+        }
+        auto const day = args[0];
+        auto const day_number = parse_number(day);
+        if(find_solver(day_number, 1) == nullptr) {
+            throw std::runtime_error{"Parameter \""s.append(day).append("\" was not a valid day (try 1-25)")};
+        }
+
+        if(args.size() < 2) {
+            throw std::runtime_error("Missing part parameter");
+        }
+        auto const part = args[1];
+        auto const* const solver = find_solver(day_number, parse_number(part));
+        if(solver == nullptr) {
+            throw std::runtime_error{"Parameter \""s.append(part).append("\" was not a valid part (try 1 or 2)")};
+        }
+        args = args.subspan(2);
+        auto const job = profile::scoped_job(solver->day, solver->part);
+
+        if(args.size() == 0 && !solver->supports_stdin) {
+            std::cerr << error_info(std::make_error_code(std::errc::invalid_argument), "Stdin input not supported for this day") << "\n";
+            return EXIT_FAILURE;
+        } else if(args.size() != 0 && args[0] == "--input" && !solver->supports_inline) {
+            std::cerr << error_info(std::make_error_code(std::errc::invalid_argument), "--input not supported for this day") << "\n";
+            return EXIT_FAILURE;
+        }
+
+        // Days that parse line by line start on stdin while it is still arriving, instead of waiting for all of it.
+        // Metrics records read it whole instead, so that they can report its size
+        auto stats = solve_stats();
+        if(args.size() == 0 && solver->parse_stream != nullptr && get_output_format() != output_format::metrics) {
+            auto const result = run_stream_solver(*solver, std::cin, &stats);
+            return print_result(*solver, result, stats);
+        }
+
+        auto const buffer = [args] {
+            auto const scope = profile::scoped_phase(profile::phase::input);
+            return read_input(args);
+        }();
+        if(!buffer) {
+            std::cerr << buffer.error() << "\n";
+            return EXIT_FAILURE;
+        }
+
+        auto const result = result_cache::solve(*solver, buffer.value().view(), &stats);
+        return print_result(*solver, result, stats);
+    }
+}
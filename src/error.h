@@ -1,38 +1,124 @@
 #pragma once
 
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
 #include <system_error>
 #include <expected.hpp>
 #include <string>
 #include <string_view>
+#include <type_traits>
 
 namespace kab_advent {
+	// An error code with a static message and a short excerpt of the text that caused it. The message is a string
+	// literal in which "{}" marks where the excerpt goes; nothing is formatted until the error is printed. The
+	// excerpt is copied into the error, so it outlives the input it came from, and is cut short past
+	// subject_capacity characters. Building, copying and dropping an error never allocates
 	class error_info {
 	public:
+		// Sized so that the whole error takes 96 bytes on 64-bit targets
+		static constexpr std::size_t subject_capacity = 58;
+
 		error_info() = default;
-		error_info(std::error_code err)
+		error_info(std::error_code err) noexcept
 			: m_err(err) {
 
 		}
-		error_info(std::error_code err, std::string_view message)
+		template<std::size_t N>
+		error_info(std::error_code err, char const (&message)[N]) noexcept
+			: m_err(err)
+			, m_message(message) {
+
+		}
+		template<std::size_t N>
+		error_info(std::error_code err, char const (&message)[N], std::string_view subject) noexcept
 			: m_err(err)
-			, m_str(message) {
+			, m_message(message) {
+			append(subject);
+		}
+
+		// Extends the excerpt, dropping whatever does not fit
+		auto append(std::string_view text) noexcept -> error_info& {
+			auto const count = std::min(text.size(), subject_capacity - m_subject_size);
+			std::copy_n(text.data(), count, m_subject + m_subject_size);
+			m_subject_size = static_cast<std::uint8_t>(m_subject_size + count);
+			m_truncated = m_truncated || count < text.size();
+			return *this;
+		}
+		template<typename IntegerT, std::enable_if_t<std::is_integral<IntegerT>::value, int> = 0>
+		auto append(IntegerT value) noexcept -> error_info& {
+			auto const result = std::to_chars(m_subject + m_subject_size, m_subject + subject_capacity, value);
+			if(result.ec == std::errc()) {
+				m_subject_size = static_cast<std::uint8_t>(result.ptr - m_subject);
+			} else {
+				m_truncated = true;
+			}
+			return *this;
+		}
 
+		// Places the error on a line of a named source, printed as "<source> line <n>: " before the message
+		template<std::size_t N>
+		auto at_line(char const (&source)[N], std::size_t line) noexcept -> error_info& {
+			m_source = source;
+			m_line = static_cast<std::uint32_t>(line);
+			return *this;
 		}
 
 		auto get_error_code() const noexcept -> std::error_code { return m_err; }
-		auto get_error_message() const noexcept -> std::string_view { return m_str; }
+		auto has_error_message() const noexcept -> bool { return m_source != nullptr || *m_message != '\0'; }
+
+		// Calls sink with each piece of the formatted message in turn
+		template<typename Sink>
+		void format_message(Sink && sink) const {
+			using namespace std::string_view_literals;
+			if(m_source != nullptr) {
+				char digits[16];
+				auto const result = std::to_chars(digits, digits + sizeof(digits), m_line);
+				sink(std::string_view(m_source));
+				sink(" line "sv);
+				sink(std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)));
+				sink(": "sv);
+			}
+
+			auto const message = std::string_view(m_message);
+			auto const mark = message.find("{}"sv);
+			if(mark == std::string_view::npos) {
+				sink(message);
+				return;
+			}
+			sink(message.substr(0, mark));
+			sink(std::string_view(m_subject, m_subject_size));
+			if(m_truncated) {
+				sink("..."sv);
+			}
+			sink(message.substr(mark + 2));
+		}
+
+		auto get_error_message() const -> std::string {
+			auto str = std::string();
+			format_message([&str] (std::string_view piece) { str.append(piece); });
+			return str;
+		}
 
 	private:
 		std::error_code m_err;
-		std::string m_str;
+		char const* m_message = "";
+		char const* m_source = nullptr;
+		std::uint32_t m_line = 0;
+		std::uint8_t m_subject_size = 0;
+		bool m_truncated = false;
+		char m_subject[subject_capacity] = {};
 	};
 
+	static_assert(std::is_trivially_copyable<error_info>::value, "error_info is copied around with every failed expected");
+
 	inline auto operator<<(std::ostream& o, error_info const& error) -> std::ostream& {
-		if (error.get_error_message().size() > 0) {
-			o << error.get_error_code().message() << ": " << error.get_error_message();
-		}
-		else {
-			o << error.get_error_code().message();
+		o << error.get_error_code().message();
+		if (error.has_error_message()) {
+			o << ": ";
+			error.format_message([&o] (std::string_view piece) { o << piece; });
 		}
 		return o;
 	}
@@ -43,4 +129,4 @@ namespace kab_advent {
 	using unexpected = tl::unexpected<E>;
 	using tl::unexpect;
 	using tl::make_unexpected;
-}
\ No newline at end of file
+}
@@ -0,0 +1,459 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <gsl/span>
+
+#include "algorithm.h"
+#include "conversion.h"
+
+namespace kab_advent {
+    namespace {
+        using namespace std::literals;
+
+        struct generator_options {
+            std::uint64_t seed = 2017;
+            // Day 9: deepest group nesting
+            std::int64_t depth = 64;
+            // Day 7: children per tower
+            std::int64_t fan_out = 3;
+            // Day 13: the delay that gets through, unless a smaller one does too
+            std::int64_t delay = 10000;
+        };
+
+        // Collects output in large chunks, so that multi-gigabyte inputs stream out without per-character stream calls
+        class chunked_writer {
+        public:
+            explicit chunked_writer(std::ostream & out)
+                : m_out(out) {
+                m_buffer.reserve(chunk_size);
+            }
+            chunked_writer(chunked_writer const&) = delete;
+            auto operator=(chunked_writer const&) -> chunked_writer & = delete;
+            ~chunked_writer() {
+                flush();
+            }
+
+            void put(char const c) {
+                m_buffer.push_back(c);
+                if(m_buffer.size() >= chunk_size) {
+                    flush();
+                }
+            }
+
+            void write(std::string_view const s) {
+                m_buffer.append(s);
+                if(m_buffer.size() >= chunk_size) {
+                    flush();
+                }
+            }
+
+            void write(std::int64_t const value) {
+                write(std::string_view(std::to_string(value)));
+            }
+
+            // Characters written so far, flushed or not
+            auto size() const noexcept -> std::uint64_t {
+                return m_flushed + m_buffer.size();
+            }
+
+            void flush() {
+                m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+                m_flushed += m_buffer.size();
+                m_buffer.clear();
+            }
+
+        private:
+            static constexpr auto chunk_size = std::size_t{1} << 20;
+
+            std::ostream & m_out;
+            std::string m_buffer;
+            std::uint64_t m_flushed = 0;
+        };
+
+        using random_engine = std::mt19937_64;
+
+        // Uniform enough for test inputs, and much cheaper than a distribution object per call
+        auto uniform(random_engine & rng, std::int64_t const low, std::int64_t const high) -> std::int64_t {
+            return low + static_cast<std::int64_t>(rng() % static_cast<std::uint64_t>(high - low + 1));
+        }
+
+        // Bijective base 26 ("a".."z", "aa"...), so that every index gets a distinct lowercase name
+        auto letters_name(std::int64_t index) -> std::string {
+            auto name = std::string();
+            ++index;
+            while(index > 0) {
+                --index;
+                name.push_back(static_cast<char>('a' + index % 26));
+                index /= 26;
+            }
+            return name;
+        }
+
+        void generate_digits(chunked_writer & out, random_engine & rng, std::int64_t const size) {
+            for(std::int64_t i = 0; i < size; ++i) {
+                out.put(static_cast<char>('0' + rng() % 10));
+            }
+            out.put('\n');
+        }
+
+        // Rows of distinct primes above 10 with one multiple of another added, so that exactly one pair per row
+        // divides evenly
+        void generate_matrix(chunked_writer & out, random_engine & rng, std::int64_t const rows) {
+            auto primes = std::vector<std::int64_t>();
+            for(std::int64_t n = 11; primes.size() < 512; n += 2) {
+                if(std::all_of(primes.begin(), primes.end(), [n] (std::int64_t const p) { return p * p > n || n % p != 0; })
+                   && n % 3 != 0 && n % 5 != 0 && n % 7 != 0) {
+                    primes.push_back(n);
+                }
+            }
+
+            constexpr auto columns = std::size_t{16};
+            auto row = std::vector<std::int64_t>(columns);
+            for(std::int64_t r = 0; r < rows; ++r) {
+                std::shuffle(primes.begin(), primes.end(), rng);
+                std::copy(primes.begin(), primes.begin() + columns - 1, row.begin());
+                row.back() = row[static_cast<std::size_t>(uniform(rng, 0, static_cast<std::int64_t>(columns) - 2))] * uniform(rng, 2, 9);
+                std::shuffle(row.begin(), row.end(), rng);
+                for(std::size_t c = 0; c < columns; ++c) {
+                    if(c != 0) {
+                        out.put('\t');
+                    }
+                    out.write(row[c]);
+                }
+                out.put('\n');
+            }
+        }
+
+        void generate_passphrases(chunked_writer & out, random_engine & rng, std::int64_t const lines) {
+            auto vocabulary = std::vector<std::string>(4096);
+            for(auto & word : vocabulary) {
+                auto const length = uniform(rng, 2, 7);
+                for(std::int64_t i = 0; i < length; ++i) {
+                    word.push_back(static_cast<char>(uniform(rng, 'a', 'z')));
+                }
+            }
+
+            for(std::int64_t line = 0; line < lines; ++line) {
+                auto const words = uniform(rng, 5, 10);
+                for(std::int64_t w = 0; w < words; ++w) {
+                    if(w != 0) {
+                        out.put(' ');
+                    }
+                    out.write(vocabulary[static_cast<std::size_t>(uniform(rng, 0, static_cast<std::int64_t>(vocabulary.size()) - 1))]);
+                }
+                out.put('\n');
+            }
+        }
+
+        void generate_separated_ints(chunked_writer & out, random_engine & rng, std::int64_t const count, std::int64_t const low, std::int64_t const high, char const separator) {
+            for(std::int64_t i = 0; i < count; ++i) {
+                if(i != 0) {
+                    out.put(separator);
+                }
+                out.write(uniform(rng, low, high));
+            }
+            out.put('\n');
+        }
+
+        // Mostly backward jumps that never leave through the front, like the puzzle's, so the runs are long
+        void generate_offsets(chunked_writer & out, random_engine & rng, std::int64_t const count) {
+            for(std::int64_t i = 0; i < count; ++i) {
+                out.write(uniform(rng, -std::min<std::int64_t>(i, 16), 2));
+                out.put('\n');
+            }
+        }
+
+        // A tree where tower k holds towers k * fan_out + 1 to k * fan_out + fan_out. Towers at the same depth weigh
+        // the same, so every complete level is balanced
+        void generate_towers(chunked_writer & out, random_engine & rng, std::int64_t const count, std::int64_t const fan_out) {
+            auto depth_weights = std::vector<std::int64_t>();
+            auto level_end = std::int64_t{1};
+            auto level_size = std::int64_t{1};
+            for(std::int64_t tower = 0; tower < count; ++tower) {
+                if(tower == level_end || depth_weights.empty()) {
+                    if(tower != 0) {
+                        level_size *= fan_out;
+                        level_end += level_size;
+                    }
+                    depth_weights.push_back(uniform(rng, 1, 99));
+                }
+
+                out.write(letters_name(tower));
+                out.write(" ("sv);
+                out.write(depth_weights.back());
+                out.put(')');
+                auto const first_child = tower * fan_out + 1;
+                for(auto child = first_child; child < count && child < first_child + fan_out; ++child) {
+                    out.write(child == first_child ? " -> "sv : ", "sv);
+                    out.write(letters_name(child));
+                }
+                out.put('\n');
+            }
+        }
+
+        void generate_instructions(chunked_writer & out, random_engine & rng, std::int64_t const count) {
+            constexpr std::array<std::string_view, 6> comparisons = {"==", "!=", "<", "<=", ">", ">="};
+            auto const register_count = std::max<std::int64_t>(26, count / 64);
+            for(std::int64_t i = 0; i < count; ++i) {
+                out.write(letters_name(uniform(rng, 0, register_count - 1)));
+                out.write(rng() % 2 == 0 ? " inc "sv : " dec "sv);
+                out.write(uniform(rng, -1000, 1000));
+                out.write(" if "sv);
+                out.write(letters_name(uniform(rng, 0, register_count - 1)));
+                out.put(' ');
+                out.write(comparisons[static_cast<std::size_t>(uniform(rng, 0, static_cast<std::int64_t>(comparisons.size()) - 1))]);
+                out.put(' ');
+                out.write(uniform(rng, -1000, 1000));
+                out.put('\n');
+            }
+        }
+
+        void generate_garbage(chunked_writer & out, random_engine & rng) {
+            constexpr auto characters = "abc{}<,'!"sv;
+            out.put('<');
+            for(auto length = uniform(rng, 0, 8); length > 0; --length) {
+                auto const c = characters[static_cast<std::size_t>(uniform(rng, 0, static_cast<std::int64_t>(characters.size()) - 1))];
+                out.put(c);
+                if(c == '!') {
+                    out.put(rng() % 2 == 0 ? '>' : '!');
+                }
+            }
+            out.put('>');
+        }
+
+        // A single outer group of about size characters, nested at most max_depth deep
+        void generate_stream(chunked_writer & out, random_engine & rng, std::int64_t const size, std::int64_t const max_depth) {
+            auto const end = out.size() + static_cast<std::uint64_t>(std::max<std::int64_t>(size, 2));
+            out.put('{');
+            auto depth = std::int64_t{1};
+            auto first = true;
+            while(depth > 0) {
+                auto const choice = out.size() + static_cast<std::uint64_t>(depth) >= end ? 7 : uniform(rng, 0, 7);
+                if(choice < 3 && depth < max_depth) {
+                    out.write(first ? "{"sv : ",{"sv);
+                    ++depth;
+                    first = true;
+                } else if(choice < 6 || (choice < 7 && depth == 1)) {
+                    if(!first) {
+                        out.put(',');
+                    }
+                    generate_garbage(out, rng);
+                    first = false;
+                } else {
+                    out.put('}');
+                    --depth;
+                    first = false;
+                }
+            }
+            out.put('\n');
+        }
+
+        void generate_directions(chunked_writer & out, random_engine & rng, std::int64_t const count) {
+            constexpr std::array<std::string_view, 6> directions = {"n", "ne", "se", "s", "sw", "nw"};
+            for(std::int64_t i = 0; i < count; ++i) {
+                if(i != 0) {
+                    out.put(',');
+                }
+                out.write(directions[static_cast<std::size_t>(uniform(rng, 0, static_cast<std::int64_t>(directions.size()) - 1))]);
+            }
+            out.put('\n');
+        }
+
+        // Mostly a random forest, so that there are many groups, with some extra links across it
+        void generate_programs(chunked_writer & out, random_engine & rng, std::int64_t const count) {
+            auto links = std::vector<std::vector<std::int32_t>>(static_cast<std::size_t>(count));
+            auto const link = [&links] (std::int64_t const a, std::int64_t const b) {
+                links[static_cast<std::size_t>(a)].push_back(static_cast<std::int32_t>(b));
+                if(a != b) {
+                    links[static_cast<std::size_t>(b)].push_back(static_cast<std::int32_t>(a));
+                }
+            };
+            for(std::int64_t program = 1; program < count; ++program) {
+                if(rng() % 4 != 0) {
+                    link(program, uniform(rng, 0, program - 1));
+                }
+            }
+            for(std::int64_t extra = 0; extra < count / 8; ++extra) {
+                link(uniform(rng, 0, count - 1), uniform(rng, 0, count - 1));
+            }
+
+            for(std::int64_t program = 0; program < count; ++program) {
+                auto & program_links = links[static_cast<std::size_t>(program)];
+                if(program_links.empty()) {
+                    program_links.push_back(static_cast<std::int32_t>(program));
+                }
+                std::sort(program_links.begin(), program_links.end());
+                out.write(program);
+                out.write(" <-> "sv);
+                for(std::size_t i = 0; i < program_links.size(); ++i) {
+                    if(i != 0) {
+                        out.write(", "sv);
+                    }
+                    out.write(std::int64_t{program_links[i]});
+                }
+                out.put('\n');
+                program_links = {};
+            }
+        }
+
+        // Every layer lets the packet through when it leaves after delay picoseconds, so part 2 always has an answer
+        void generate_layers(chunked_writer & out, random_engine & rng, std::int64_t const count, std::int64_t const delay) {
+            auto depth = std::int64_t{0};
+            for(std::int64_t layer = 0; layer < count; ++layer) {
+                auto range = std::int64_t{0};
+                do {
+                    range = uniform(rng, 2, 20);
+                } while((delay + depth) % (2 * range - 2) == 0);
+
+                out.write(depth);
+                out.write(": "sv);
+                out.write(range);
+                out.put('\n');
+                depth += uniform(rng, 1, 3);
+            }
+        }
+
+        void generate_key(chunked_writer & out, random_engine & rng, std::int64_t const length) {
+            for(std::int64_t i = 0; i < length; ++i) {
+                out.put(static_cast<char>(uniform(rng, 'a', 'z')));
+            }
+            out.put('\n');
+        }
+
+        constexpr auto last_day = 15;
+
+        // Day 6 keeps every state it has seen and searches them linearly, and random banks take about banks^2 / 3
+        // steps to repeat, so its runtime grows faster than banks^5. 128 banks solve in a few seconds at most
+        constexpr auto max_day6_banks = std::int64_t{128};
+
+        // Rejects sizes whose input the day's solver cannot finish
+        void check_size(int const day, std::int64_t const size) {
+            if(day == 6 && size > max_day6_banks) {
+                throw std::runtime_error("Day 6 inputs are limited to "s.append(std::to_string(max_day6_banks)).append(" banks, got ").append(std::to_string(size)));
+            }
+        }
+
+        // Size counts the natural unit of each day: digits, rows, lines, banks, towers, instructions, characters,
+        // lengths, steps, programs, layers or key characters. Day 3 uses it as the square and day 15 ignores it
+        void generate(std::ostream & o, int const day, std::int64_t const size, generator_options const& options) {
+            auto rng = random_engine(options.seed);
+            auto out = chunked_writer(o);
+            switch(day) {
+                case 1: generate_digits(out, rng, size); break;
+                case 2: generate_matrix(out, rng, size); break;
+                case 3: out.write(std::max<std::int64_t>(size, 2)); out.put('\n'); break;
+                case 4: generate_passphrases(out, rng, size); break;
+                case 5: generate_offsets(out, rng, size); break;
+                case 6: generate_separated_ints(out, rng, size, 0, 15, '\t'); break;
+                case 7: generate_towers(out, rng, size, options.fan_out); break;
+                case 8: generate_instructions(out, rng, size); break;
+                case 9: generate_stream(out, rng, size, options.depth); break;
+                case 10: generate_separated_ints(out, rng, size, 0, 255, ','); break;
+                case 11: generate_directions(out, rng, size); break;
+                case 12: generate_programs(out, rng, size); break;
+                case 13: generate_layers(out, rng, size, options.delay); break;
+                case 14: generate_key(out, rng, size); break;
+                case 15: out.write(uniform(rng, 1, 2147483646)); out.put(' '); out.write(uniform(rng, 1, 2147483646)); out.put('\n'); break;
+                default: throw std::runtime_error("No generator for day "s.append(std::to_string(day)).append(" (try 1-").append(std::to_string(last_day)).append(")"));
+            }
+        }
+
+        auto parse_size(std::string_view arg, std::string_view what) -> std::int64_t {
+            auto const result = to_integer<std::int64_t>(arg);
+            if(!result || result.value().conversion_end != arg.data() + arg.size() || result.value().data < 0) {
+                throw std::runtime_error("Expected "s.append(what).append(", got \"").append(arg).append("\""));
+            }
+            return result.value().data;
+        }
+
+        auto parse_day(std::string_view arg) -> int {
+            auto const day = parse_size(arg, "a day");
+            if(day < 1 || day > last_day) {
+                throw std::runtime_error("No generator for day "s.append(arg).append(" (try 1-").append(std::to_string(last_day)).append(")"));
+            }
+            return static_cast<int>(day);
+        }
+
+        auto parse_options(gsl::span<std::string_view const> & args) -> generator_options {
+            auto options = generator_options();
+            while(args.size() >= 1 && begins_with(args[0], "--") && args[0] != "--series") {
+                if(args.size() < 2) {
+                    throw std::runtime_error("Missing value after "s.append(args[0]));
+                }
+                auto const value = parse_size(args[1], "a number after "s.append(args[0]));
+                if(args[0] == "--seed") {
+                    options.seed = static_cast<std::uint64_t>(value);
+                } else if(args[0] == "--depth") {
+                    options.depth = std::max<std::int64_t>(value, 1);
+                } else if(args[0] == "--fan-out") {
+                    options.fan_out = std::max<std::int64_t>(value, 1);
+                } else if(args[0] == "--delay") {
+                    options.delay = value;
+                } else {
+                    throw std::runtime_error("Invalid parameter \""s.append(args[0]).append("\""));
+                }
+                args = args.subspan(2);
+            }
+            return options;
+        }
+
+        // Writes inputs of doubling sizes from min_size to max_size, then a manifest benchmarking both parts on each
+        // of them, so that aoc_bench reports runtime against input_bytes
+        auto generate_series(gsl::span<std::string_view const> args, generator_options const& options) -> int {
+            if(args.size() != 4) {
+                throw std::runtime_error("Usage: aoc_generate [options] --series <day> <min size> <max size> <directory>");
+            }
+            auto const day = parse_day(args[0]);
+            auto const max_size = parse_size(args[2], "a maximum size");
+            check_size(day, max_size);
+            auto const directory = std::string(args[3]);
+            for(auto size = std::max<std::int64_t>(parse_size(args[1], "a minimum size"), 1); size <= max_size; size *= 2) {
+                auto const path = directory + "/day"s.append(day < 10 ? "0" : "").append(std::to_string(day)).append("-").append(std::to_string(size)).append(".txt");
+                auto file = std::ofstream(path, std::ios::binary);
+                generate(file, day, size, options);
+                if(!file) {
+                    std::cerr << "Could not write \"" << path << "\"\n";
+                    return EXIT_FAILURE;
+                }
+                std::cout << day << " 1 " << path << "\n" << day << " 2 " << path << "\n";
+            }
+            return EXIT_SUCCESS;
+        }
+    }
+}
+
+// Writes a valid puzzle input of any size for every implemented day, to scale solvers far past puzzle-sized inputs.
+// "aoc_generate <day> <size>" writes one input to stdout, "--series" writes a range of sizes and an aoc_bench manifest
+int main( int argc, const char* argv[] ) try {
+	std::cout.sync_with_stdio(false);
+
+	auto const all_args = std::vector<std::string_view>( argv + 1, argv + argc );
+	auto args = gsl::span<std::string_view const>( all_args );
+	auto const options = kab_advent::parse_options( args );
+
+	if ( !args.empty() && args[0] == "--series" ) {
+		return kab_advent::generate_series( args.subspan( 1 ), options );
+	}
+	if ( args.size() != 2 ) {
+		throw std::runtime_error( "Usage: aoc_generate [--seed <n>] [--depth <n>] [--fan-out <n>] [--delay <n>] <day> <size>" );
+	}
+
+	auto const day = kab_advent::parse_day( args[0] );
+	auto const size = kab_advent::parse_size( args[1], "a size" );
+	kab_advent::check_size( day, size );
+	kab_advent::generate( std::cout, day, size, options );
+	std::cout.flush();
+	return std::cout ? EXIT_SUCCESS : EXIT_FAILURE;
+} catch ( const std::exception & e ) {
+	std::cerr << "Error: " << e.what() << "\n";
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,285 @@
+#include "input.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include "algorithm.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace kab_advent {
+    namespace {
+        using namespace std::literals;
+
+        struct mapped_file {
+            void* data;
+            std::size_t size;
+        };
+
+        // Returns a null mapping when the file exists but cannot be mapped (pipes, character devices, empty files),
+        // in which case the caller falls back to a buffered read
+        auto map_file(std::string const& filepath) -> expected<mapped_file> {
+#if defined(_WIN32)
+            auto const file = ::CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if(file == INVALID_HANDLE_VALUE) {
+                return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "File \"{}\" could not be opened", filepath));
+            }
+
+            auto file_size = LARGE_INTEGER();
+            if(::GetFileType(file) != FILE_TYPE_DISK || !::GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+                ::CloseHandle(file);
+                return mapped_file{nullptr, 0};
+            }
+
+            auto const mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            ::CloseHandle(file);
+            if(mapping == nullptr) {
+                return mapped_file{nullptr, 0};
+            }
+
+            auto const data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            ::CloseHandle(mapping);
+            if(data == nullptr) {
+                return mapped_file{nullptr, 0};
+            }
+
+            return mapped_file{data, static_cast<std::size_t>(file_size.QuadPart)};
+#else
+            auto const fd = ::open(filepath.c_str(), O_RDONLY);
+            if(fd == -1) {
+                return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "File \"{}\" could not be opened", filepath));
+            }
+
+            struct stat file_stat;
+            if(::fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) || file_stat.st_size == 0) {
+                ::close(fd);
+                return mapped_file{nullptr, 0};
+            }
+
+            auto const size = static_cast<std::size_t>(file_stat.st_size);
+            auto const data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if(data == MAP_FAILED) {
+                return mapped_file{nullptr, 0};
+            }
+
+            ::madvise(data, size, MADV_SEQUENTIAL);
+            return mapped_file{data, size};
+#endif
+        }
+
+        void unmap_file(void* data, std::size_t size) noexcept {
+#if defined(_WIN32)
+            (void)size;
+            ::UnmapViewOfFile(data);
+#else
+            ::munmap(data, size);
+#endif
+        }
+
+        auto process_id() noexcept -> unsigned long {
+#if defined(_WIN32)
+            return static_cast<unsigned long>(::GetCurrentProcessId());
+#else
+            return static_cast<unsigned long>(::getpid());
+#endif
+        }
+
+        // Creates a temporary next to the target file, named per process and per call, and opened exclusively
+        // so that a leftover or concurrent temporary is never written through
+        auto create_temporary(std::string const& filepath, std::string & temporary) -> std::FILE* {
+            static auto counter = std::atomic<unsigned long>(0);
+            auto constexpr max_attempts = 16;
+            for(auto attempt = 0; attempt < max_attempts; ++attempt) {
+                temporary = filepath + ".tmp"s.append(std::to_string(process_id())).append("-").append(std::to_string(counter++));
+                errno = 0;
+                if(auto const file = std::fopen(temporary.c_str(), "wbx")) {
+                    return file;
+                }
+                if(errno != EEXIST) {
+                    break;
+                }
+            }
+            return nullptr;
+        }
+
+        auto executable_path() -> std::filesystem::path {
+#if defined(_WIN32)
+            wchar_t path[MAX_PATH];
+            auto const length = ::GetModuleFileNameW(nullptr, path, MAX_PATH);
+            if(length == 0 || length == MAX_PATH) {
+                return {};
+            }
+            return std::filesystem::path(path, path + length);
+#elif defined(__linux__)
+            return "/proc/self/exe";
+#else
+            return {};
+#endif
+        }
+    }
+
+    input_buffer::input_buffer(input_buffer && other) noexcept {
+        *this = std::move(other);
+    }
+
+    auto input_buffer::operator=(input_buffer && other) noexcept -> input_buffer & {
+        if(this != &other) {
+            release();
+            // Moving a small std::string moves its characters too, so a view over the storage must be rebuilt
+            auto const owns_storage = !other.m_storage.empty() && other.m_view.data() == other.m_storage.data();
+            m_view = std::exchange(other.m_view, {});
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+            m_mapping_size = std::exchange(other.m_mapping_size, 0);
+            m_storage = std::move(other.m_storage);
+            if(owns_storage) {
+                m_view = m_storage;
+            }
+        }
+        return *this;
+    }
+
+    input_buffer::~input_buffer() {
+        release();
+    }
+
+    void input_buffer::release() noexcept {
+        if(m_mapping != nullptr) {
+            unmap_file(m_mapping, m_mapping_size);
+            m_mapping = nullptr;
+            m_mapping_size = 0;
+        }
+        m_view = {};
+    }
+
+    auto input_buffer::from_file(std::string_view filepath) -> expected<input_buffer> {
+        auto const path = std::string(filepath);
+        auto const mapping = map_file(path);
+        if(!mapping) {
+            return make_unexpected(mapping.error());
+        }
+
+        if(mapping.value().data == nullptr) {
+            auto file = std::ifstream(path, std::ios::binary);
+            if(!file) {
+                return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "File \"{}\" could not be opened", filepath));
+            }
+            return from_stream(file);
+        }
+
+        auto buffer = input_buffer();
+        buffer.m_mapping = mapping.value().data;
+        buffer.m_mapping_size = mapping.value().size;
+        buffer.m_view = std::string_view(static_cast<char const*>(buffer.m_mapping), buffer.m_mapping_size);
+        return buffer;
+    }
+
+    auto input_buffer::from_stream(std::istream & stream) -> expected<input_buffer> {
+        auto constexpr chunk_size = std::size_t{64 * 1024};
+
+        auto buffer = input_buffer();
+        auto read_size = std::size_t{0};
+        do {
+            buffer.m_storage.resize(read_size + chunk_size);
+            stream.read(buffer.m_storage.data() + read_size, chunk_size);
+            read_size += static_cast<std::size_t>(stream.gcount());
+        } while(stream);
+
+        if(stream.bad()) {
+            return make_unexpected(error_info(std::make_error_code(std::errc::io_error), "Could not read input"));
+        }
+
+        buffer.m_storage.resize(read_size);
+        buffer.m_view = buffer.m_storage;
+        return buffer;
+    }
+
+    auto input_buffer::from_view(std::string_view input) noexcept -> input_buffer {
+        auto buffer = input_buffer();
+        buffer.m_view = input;
+        return buffer;
+    }
+
+    auto read_input(gsl::span<std::string_view const> args) -> expected<input_buffer> {
+        if(args.size() == 0) {
+            return input_buffer::from_stream(std::cin);
+        } else if(args[0] == "--input") {
+            if(args.size() < 2) {
+                return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing input after --input"));
+            }
+
+            return input_buffer::from_view(args[1]);
+        } else if(args[0] == "--file") {
+            if(args.size() < 2) {
+                return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Missing filename after --file"));
+            }
+
+            return input_buffer::from_file(args[1]);
+        } else {
+            return make_unexpected(
+                error_info(std::make_error_code(std::errc::invalid_argument), "Invalid parameter \"{}\"", args[0])
+            );
+        }
+    }
+
+    auto replace_file(std::string const& filepath, std::string_view contents) -> bool {
+        auto temporary = std::string();
+        auto const file = create_temporary(filepath, temporary);
+        if(file == nullptr) {
+            return false;
+        }
+
+        auto const written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+        if(std::fclose(file) == 0 && written) {
+            // Unlike std::rename, replaces an existing file on Windows too
+            auto ec = std::error_code();
+            std::filesystem::rename(temporary, filepath, ec);
+            if(!ec) {
+                return true;
+            }
+        }
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    auto build_stamp() noexcept -> std::uint64_t {
+        static auto const stamp = [] () noexcept -> std::uint64_t {
+            try {
+                auto const path = executable_path();
+                if(path.empty()) {
+                    return 0;
+                }
+                auto ec = std::error_code();
+                auto const size = std::filesystem::file_size(path, ec);
+                if(ec) {
+                    return 0;
+                }
+                auto const write_time = std::filesystem::last_write_time(path, ec);
+                if(ec) {
+                    return 0;
+                }
+                std::uint64_t const fields[2] = {static_cast<std::uint64_t>(size), static_cast<std::uint64_t>(write_time.time_since_epoch().count())};
+                auto const stamp = hash_bytes(std::string_view(reinterpret_cast<char const*>(fields), sizeof(fields)));
+                return stamp != 0 ? stamp : 1;
+            } catch(std::exception const&) {
+                return 0;
+            }
+        }();
+        return stamp;
+    }
+}
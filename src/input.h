@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <gsl/span>
+
+#include "error.h"
+
+namespace kab_advent {
+    // Read-only view over a puzzle input. File inputs are memory-mapped and parsed in place,
+    // stream inputs are read into an owned buffer, and inline inputs only borrow the argument.
+    class input_buffer {
+    public:
+        input_buffer() = default;
+        input_buffer(input_buffer const&) = delete;
+        input_buffer(input_buffer && other) noexcept;
+        auto operator=(input_buffer const&) -> input_buffer & = delete;
+        auto operator=(input_buffer && other) noexcept -> input_buffer &;
+        ~input_buffer();
+
+        static auto from_file(std::string_view filepath) -> expected<input_buffer>;
+        static auto from_stream(std::istream & stream) -> expected<input_buffer>;
+        static auto from_view(std::string_view input) noexcept -> input_buffer;
+
+        auto view() const noexcept -> std::string_view { return m_view; }
+        auto size() const noexcept -> std::size_t { return m_view.size(); }
+
+    private:
+        void release() noexcept;
+
+        std::string_view m_view;
+        std::string m_storage;
+        void* m_mapping = nullptr;
+        std::size_t m_mapping_size = 0;
+    };
+
+    // Handles the input arguments shared by every day: no argument reads stdin, "--input <text>"
+    // uses the argument itself and "--file <path>" maps the file
+    auto read_input(gsl::span<std::string_view const> args) -> expected<input_buffer>;
+
+    // Writes the file under a temporary name next to it, then renames it into place, so that concurrent readers and
+    // writers of the file never see half of it. Returns false, leaving no temporary file behind, when either step fails
+    auto replace_file(std::string const& filepath, std::string_view contents) -> bool;
+
+    // Identifies the build of the running executable by hashing its size and modification time, so that files
+    // cached by one build are not trusted by another. Returns 0 when the executable cannot be found
+    auto build_stamp() noexcept -> std::uint64_t;
+}
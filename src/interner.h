@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "algorithm.h"
+
+namespace kab_advent {
+    // Maps identifiers to dense ids, numbered from 0 in the order they are first seen, so that solvers can index
+    // flat arrays instead of comparing or hashing names. By default only views are kept: the interned text must outlive
+    // the interner, unless it was told to keep copies
+    class string_interner {
+    public:
+        explicit string_interner(std::pmr::memory_resource * memory = std::pmr::get_default_resource())
+            : m_ids(memory)
+            , m_names(memory) {
+        }
+
+        // Copies every name seen from now on into the interner's memory, for text that is gone once interned
+        void keep_copies() noexcept {
+            m_keep_copies = true;
+        }
+
+        auto intern(std::string_view const name) -> int {
+            if(m_keep_copies) {
+                auto const id = find(name);
+                return id != -1 ? id : intern_new(copy(name));
+            }
+            auto const [it, inserted] = m_ids.try_emplace(name, static_cast<int>(m_names.size()));
+            if(inserted) {
+                m_names.push_back(name);
+            }
+            return it->second;
+        }
+
+        // Returns -1 for a name that was never interned
+        auto find(std::string_view const name) const -> int {
+            auto const it = m_ids.find(name);
+            return it != m_ids.end() ? it->second : -1;
+        }
+
+        auto name(int const id) const -> std::string_view {
+            return m_names[static_cast<std::size_t>(id)];
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return m_names.size();
+        }
+
+    private:
+        auto copy(std::string_view const name) -> std::string_view {
+            auto * const stored = static_cast<char*>(m_names.get_allocator().resource()->allocate(name.size(), alignof(char)));
+            std::copy(name.begin(), name.end(), stored);
+            return std::string_view(stored, name.size());
+        }
+
+        auto intern_new(std::string_view const name) -> int {
+            auto const id = static_cast<int>(m_names.size());
+            m_ids.try_emplace(name, id);
+            m_names.push_back(name);
+            return id;
+        }
+
+        flat_hash_map<std::string_view, int, string_hash, std::equal_to<>, 8, std::pmr::polymorphic_allocator<std::pair<std::string_view const, int>>> m_ids;
+        std::pmr::vector<std::string_view> m_names;
+        bool m_keep_copies = false;
+    };
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string_view>
+
+#include "error.h"
+#include "solver.h"
+
+// In-process entry point for embedding the solvers, built as the kab_advent static library. Unlike the command line,
+// it reads nothing but its arguments and writes nothing but its result: no iostreams, no caches, no profiling
+namespace kab_advent {
+    // Parses the input text and solves one part of a day. Safe to call from any number of threads at once.
+    // Unknown days and parts, malformed inputs and parts that are not implemented are reported as errors
+    auto solve(int day, int part, std::string_view input) -> expected<answer>;
+}
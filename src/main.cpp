@@ -1,4 +1,5 @@
 #include <iostream>
+#include <fstream>
 #include <exception>
 #include <string>
 #include <vector>
@@ -7,16 +8,108 @@
 #include <string_view>
 #include <system_error>
 
+#include "batch.h"
 #include "day.h"
+#include "parse_cache.h"
+#include "profile.h"
+#include "result_cache.h"
+#include "result_writer.h"
+#include "server.h"
+
+namespace {
+	auto run( gsl::span<std::string_view const> args ) -> int {
+		if ( !args.empty() && args[0] == "--batch" ) {
+			return kab_advent::batch( args.subspan( 1 ) );
+		}
+		if ( !args.empty() && args[0] == "--serve" ) {
+			return kab_advent::serve( args.subspan( 1 ) );
+		}
+		if ( !args.empty() && args[0] == "--client" ) {
+			return kab_advent::client( args.subspan( 1 ) );
+		}
+		return kab_advent::day( args );
+	}
+}
 
 int main( int argc, const char* argv[] ) try {
 	std::cout.sync_with_stdio(false);
 	std::cerr.sync_with_stdio(false);
 	std::cin.sync_with_stdio(false);
 	
-	auto const args = std::vector<std::string_view>( argv + 1, argv + argc );
+	auto const all_args = std::vector<std::string_view>( argv + 1, argv + argc );
+	auto args = gsl::span<std::string_view const>( all_args );
 	try {
-		return kab_advent::day(args);
+		auto profiling = false;
+		auto counting = false;
+		auto trace_path = std::string_view();
+		while ( !args.empty() ) {
+			if ( args[0] == "--profile" ) {
+				profiling = true;
+				kab_advent::profile::enable();
+				args = args.subspan( 1 );
+			} else if ( args[0] == "--counters" ) {
+				counting = true;
+				kab_advent::profile::enable_counters();
+				args = args.subspan( 1 );
+			} else if ( args[0] == "--trace" ) {
+				if ( args.size() < 2 ) {
+					throw std::runtime_error( "Missing filename after --trace" );
+				}
+				trace_path = args[1];
+				kab_advent::profile::enable_trace();
+				args = args.subspan( 2 );
+			} else if ( args[0] == "--format" ) {
+				if ( args.size() < 2 ) {
+					throw std::runtime_error( "Missing format after --format" );
+				}
+				if ( args[1] == "text" ) {
+					kab_advent::set_output_format( kab_advent::output_format::text );
+				} else if ( args[1] == "ndjson" ) {
+					kab_advent::set_output_format( kab_advent::output_format::ndjson );
+				} else if ( args[1] == "metrics" ) {
+					// Metrics are taken by the profiler's phase probes, without printing its report
+					kab_advent::set_output_format( kab_advent::output_format::metrics );
+					kab_advent::profile::enable();
+				} else {
+					throw std::runtime_error( "Expected text, ndjson or metrics after --format" );
+				}
+				args = args.subspan( 2 );
+			} else if ( args[0] == "--no-cache" ) {
+				kab_advent::result_cache::disable();
+				args = args.subspan( 1 );
+			} else if ( args[0] == "--cache-dir" ) {
+				if ( args.size() < 2 ) {
+					throw std::runtime_error( "Missing directory after --cache-dir" );
+				}
+				kab_advent::result_cache::set_directory( args[1] );
+				args = args.subspan( 2 );
+			} else if ( args[0] == "--parse-cache" ) {
+				if ( args.size() < 2 ) {
+					throw std::runtime_error( "Missing directory after --parse-cache" );
+				}
+				kab_advent::parse_cache::enable( args[1] );
+				args = args.subspan( 2 );
+			} else {
+				break;
+			}
+		}
+
+		auto const status = run( args );
+		if ( profiling ) {
+			kab_advent::profile::report( std::cerr );
+		}
+		if ( counting ) {
+			kab_advent::profile::report_counters( std::cerr );
+		}
+		if ( !trace_path.empty() ) {
+			auto trace = std::ofstream( std::string( trace_path ) );
+			kab_advent::profile::write_trace( trace );
+			if ( !trace ) {
+				std::cerr << "Could not write trace to \"" << trace_path << "\"\n";
+				return EXIT_FAILURE;
+			}
+		}
+		return status;
 	}
 	catch ( const std::runtime_error & e ) {
 		std::cerr << "Invalid input: " << e.what() << "\n";
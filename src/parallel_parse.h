@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "error.h"
+#include "profile.h"
+#include "thread_pool.h"
+
+// Parallel parsing of line-oriented inputs: the text is split at newlines into one chunk per hardware thread, the
+// chunks are parsed by the day's line parser on the calling thread and on a pool of helpers shared by the whole
+// process, and the chunk results are joined in text order
+namespace kab_advent {
+    // Below this many bytes per thread, handing a chunk to a helper costs more than it saves
+    constexpr auto min_parallel_chunk_size = std::size_t{1} << 20;
+
+    inline auto parallel_chunk_count(std::size_t const text_size) noexcept -> std::size_t {
+        auto const threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        return std::clamp<std::size_t>(text_size / min_parallel_chunk_size, 1, threads);
+    }
+
+    // Splits text into at most chunk_count pieces of similar size, each ending just after a newline or at the end of
+    // the text, so that no line is split between two pieces
+    inline auto split_lines(std::string_view const text, std::size_t const chunk_count) -> std::vector<std::string_view> {
+        auto chunks = std::vector<std::string_view>();
+        auto const target_size = text.size() / std::max<std::size_t>(chunk_count, 1) + 1;
+        auto begin = std::size_t{0};
+        while(begin < text.size()) {
+            auto end = text.size();
+            if(text.size() - begin > target_size) {
+                auto const newline = text.find('\n', begin + target_size - 1);
+                end = newline != std::string_view::npos ? newline + 1 : text.size();
+            }
+            chunks.push_back(text.substr(begin, end - begin));
+            begin = end;
+        }
+        return chunks;
+    }
+
+    namespace detail {
+        // One helper per hardware thread besides the caller's, created by the first parallel parse. Every parse in
+        // the process shares them, so that concurrent parses (batch jobs, server requests, library calls) never run
+        // more than one helper per extra hardware thread between them
+        inline auto parse_helpers() -> thread_pool & {
+            static auto pool = thread_pool(std::max<std::size_t>(std::thread::hardware_concurrency(), 2) - 1);
+            return pool;
+        }
+
+        // Chunks are claimed in order by the caller and by helpers alike. A helper that starts after the last chunk
+        // was claimed returns without touching the parse, which the caller may have left by then.
+        // Made on the calling thread, so that helpers charge their allocations to its phase
+        struct chunk_progress {
+            explicit chunk_progress(std::size_t count) noexcept
+                : count(count) {
+            }
+
+            std::size_t const count;
+            profile::heap_share heap;
+            std::atomic<std::size_t> next{0};
+            std::mutex mutex;
+            std::condition_variable all_done;
+            std::size_t done = 0;
+        };
+    }
+
+    // Calls parse_chunk on every chunk of the text, and returns the results in text order. The caller parses chunks
+    // too, and only waits for the ones a helper has already started, so a parse never waits on busy helpers.
+    // An exception from any chunk is rethrown once all are done
+    template<typename ParseChunk>
+    auto parse_line_chunks(std::string_view const text, ParseChunk const& parse_chunk) -> std::vector<std::invoke_result_t<ParseChunk const&, std::string_view>> {
+        using result_t = std::invoke_result_t<ParseChunk const&, std::string_view>;
+        auto const chunks = split_lines(text, parallel_chunk_count(text.size()));
+        auto results = std::vector<std::optional<result_t>>(chunks.size());
+        auto errors = std::vector<std::exception_ptr>(chunks.size());
+        auto const parse = [&] (std::size_t const i) {
+            try {
+                results[i].emplace(parse_chunk(chunks[i]));
+            } catch(...) {
+                errors[i] = std::current_exception();
+            }
+        };
+
+        auto const progress = std::make_shared<detail::chunk_progress>(chunks.size());
+        auto const claim_chunks = [&parse, progress] (bool const helper) {
+            for(auto i = progress->next.fetch_add(1); i < progress->count; i = progress->next.fetch_add(1)) {
+                if(helper) {
+                    auto const charge = profile::heap_share::scoped_helper(progress->heap);
+                    parse(i);
+                } else {
+                    parse(i);
+                }
+                auto const lock = std::lock_guard<std::mutex>(progress->mutex);
+                if(++progress->done == progress->count) {
+                    progress->all_done.notify_all();
+                }
+            }
+        };
+
+        try {
+            for(std::size_t i = 1; i < chunks.size(); ++i) {
+                detail::parse_helpers().submit([claim_chunks] { claim_chunks(true); });
+            }
+        } catch(...) {
+            // The caller parses whatever chunks no helper could be asked to
+        }
+        claim_chunks(false);
+        {
+            auto lock = std::unique_lock<std::mutex>(progress->mutex);
+            progress->all_done.wait(lock, [&progress] { return progress->done == progress->count; });
+        }
+        progress->heap.merge();
+
+        auto joined = std::vector<result_t>();
+        joined.reserve(results.size());
+        for(std::size_t i = 0; i < results.size(); ++i) {
+            if(errors[i]) {
+                std::rethrow_exception(errors[i]);
+            }
+            joined.push_back(std::move(*results[i]));
+        }
+        return joined;
+    }
+
+    // Concatenates the chunk vectors of parse_line_chunks, or returns the error of the first chunk that failed
+    template<typename T>
+    auto concatenate_chunks(std::vector<expected<std::vector<T>>> chunks) -> expected<std::vector<T>> {
+        auto size = std::size_t{0};
+        for(auto const& chunk : chunks) {
+            if(!chunk) {
+                return make_unexpected(chunk.error());
+            }
+            size += chunk.value().size();
+        }
+        if(chunks.size() == 1) {
+            return std::move(chunks.front());
+        }
+
+        auto joined = std::vector<T>();
+        joined.reserve(size);
+        for(auto & chunk : chunks) {
+            std::move(chunk.value().begin(), chunk.value().end(), std::back_inserter(joined));
+        }
+        return joined;
+    }
+}
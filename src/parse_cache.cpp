@@ -0,0 +1,121 @@
+#include "parse_cache.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+#include "algorithm.h"
+#include "input.h"
+#include "solver.h"
+
+namespace kab_advent::parse_cache {
+    namespace {
+        using namespace std::literals;
+
+        // Bumped whenever the entry header changes. Changes to a day's cached layout are caught by the build stamp
+        constexpr auto format_version = std::uint32_t{2};
+        constexpr char magic[4] = {'K', 'A', 'B', 'P'};
+
+        struct entry_header {
+            char magic[4];
+            std::uint32_t version;
+            std::uint32_t day;
+            std::uint32_t pointer_size;
+            std::uint64_t text_size;
+            std::uint64_t text_hash;
+            std::uint64_t build;
+            std::uint64_t payload_size;
+        };
+
+        // Set once by enable, before any solver runs
+        auto cache_directory = std::filesystem::path();
+
+        auto entry_path(int day, std::uint64_t text_hash) -> std::filesystem::path {
+            char name[48];
+            std::snprintf(name, sizeof(name), "day%02d-%016llx.bin", day, static_cast<unsigned long long>(text_hash));
+            return cache_directory / name;
+        }
+
+        auto make_header(int day, std::string_view text, std::uint64_t text_hash, std::size_t payload_size) noexcept -> entry_header {
+            auto header = entry_header();
+            std::memcpy(header.magic, magic, sizeof(magic));
+            header.version = format_version;
+            header.day = static_cast<std::uint32_t>(day);
+            header.pointer_size = static_cast<std::uint32_t>(sizeof(void*));
+            header.text_size = text.size();
+            header.text_hash = text_hash;
+            header.build = build_stamp();
+            header.payload_size = payload_size;
+            return header;
+        }
+
+        // A missing, stale or unreadable entry is a cache miss, reported as an empty pointer
+        auto load_entry(solver const& s, std::filesystem::path const& path, entry_header const& expected_header) -> parsed_input {
+            auto ec = std::error_code();
+            if(!std::filesystem::is_regular_file(path, ec)) {
+                return nullptr;
+            }
+
+            auto const entry = input_buffer::from_file(path.string());
+            if(!entry) {
+                return nullptr;
+            }
+
+            auto reader = binary_reader(entry.value().view());
+            auto header = entry_header();
+            if(!reader.read(header)
+               || std::memcmp(header.magic, expected_header.magic, sizeof(magic)) != 0
+               || header.version != expected_header.version
+               || header.day != expected_header.day
+               || header.pointer_size != expected_header.pointer_size
+               || header.text_size != expected_header.text_size
+               || header.text_hash != expected_header.text_hash
+               || header.build != expected_header.build
+               || header.payload_size != entry.value().size() - sizeof(header)) {
+                return nullptr;
+            }
+
+            auto loaded = s.load(entry.value().view().substr(sizeof(header)));
+            return loaded ? std::move(loaded).value() : nullptr;
+        }
+    }
+
+    void enable(std::string_view directory) {
+        auto path = std::filesystem::path(directory);
+        auto ec = std::error_code();
+        std::filesystem::create_directories(path, ec);
+        if(ec || !std::filesystem::is_directory(path, ec)) {
+            throw std::runtime_error("Could not create parse cache directory \""s.append(directory).append("\""));
+        }
+        cache_directory = std::move(path);
+    }
+
+    auto enabled() noexcept -> bool {
+        return !cache_directory.empty();
+    }
+
+    auto parse(solver const& s, std::string_view text) -> expected<parsed_input> {
+        // Without a build stamp, entries written by another build could not be told apart
+        if(!enabled() || s.save == nullptr || s.load == nullptr || build_stamp() == 0) {
+            return s.parse(text);
+        }
+
+        auto const text_hash = hash_bytes(text);
+        auto const path = entry_path(s.day, text_hash);
+        auto header = make_header(s.day, text, text_hash, 0);
+        if(auto cached = load_entry(s, path, header)) {
+            return cached;
+        }
+
+        auto parsed = s.parse(text);
+        if(parsed) {
+            auto payload = std::string();
+            s.save(parsed.value(), payload);
+            header.payload_size = payload.size();
+            payload.insert(0, reinterpret_cast<char const*>(&header), sizeof(header));
+            replace_file(path.string(), payload);
+        }
+        return parsed;
+    }
+}
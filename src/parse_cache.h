@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <gsl/span>
+
+#include "error.h"
+
+namespace kab_advent {
+    struct solver;
+
+    // Appends values to a cache entry in the host's own byte order. Entries are only read back by the build that wrote them
+    class binary_writer {
+    public:
+        explicit binary_writer(std::string & out) noexcept
+            : m_out(out) {
+        }
+
+        template<typename T>
+        void write(T const& value) {
+            static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written as bytes");
+            m_out.append(reinterpret_cast<char const*>(&value), sizeof(value));
+        }
+
+        // Writes the element count, then the elements
+        template<typename T>
+        void write_array(gsl::span<T const> values) {
+            static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written as bytes");
+            write(static_cast<std::uint64_t>(values.size()));
+            m_out.append(reinterpret_cast<char const*>(values.data()), values.size() * sizeof(T));
+        }
+
+        void write_string(std::string_view const s) {
+            write_array(gsl::span<char const>(s.data(), s.size()));
+        }
+
+    private:
+        std::string & m_out;
+    };
+
+    // Reads back what a binary_writer wrote. Every read returns false, and leaves the reader unchanged, when the
+    // entry is too short to hold the value
+    class binary_reader {
+    public:
+        explicit binary_reader(std::string_view const bytes) noexcept
+            : m_bytes(bytes) {
+        }
+
+        auto empty() const noexcept -> bool { return m_bytes.empty(); }
+
+        template<typename T>
+        auto read(T & value) noexcept -> bool {
+            static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read as bytes");
+            if(m_bytes.size() < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&value, m_bytes.data(), sizeof(T));
+            m_bytes.remove_prefix(sizeof(T));
+            return true;
+        }
+
+        // Reads an element count, checking that the entry holds that many elements of element_size bytes
+        auto read_count(std::size_t const element_size, std::size_t & count) noexcept -> bool {
+            auto stored = std::uint64_t{0};
+            auto rest = *this;
+            if(!rest.read(stored) || stored > rest.m_bytes.size() / element_size) {
+                return false;
+            }
+            count = static_cast<std::size_t>(stored);
+            *this = rest;
+            return true;
+        }
+
+        // Views the bytes of a string written by write_string. The view points into the cache entry
+        auto read_string(std::string_view & s) noexcept -> bool {
+            auto size = std::size_t{0};
+            auto rest = *this;
+            if(!rest.read_count(1, size)) {
+                return false;
+            }
+            s = rest.m_bytes.substr(0, size);
+            rest.m_bytes.remove_prefix(size);
+            *this = rest;
+            return true;
+        }
+
+        // Copies the elements of an array written by write_array to out, which must have room for count elements
+        template<typename T>
+        auto read_elements(T * out, std::size_t const count) noexcept -> bool {
+            static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read as bytes");
+            if(count > m_bytes.size() / sizeof(T)) {
+                return false;
+            }
+            std::memcpy(out, m_bytes.data(), count * sizeof(T));
+            m_bytes.remove_prefix(count * sizeof(T));
+            return true;
+        }
+
+    private:
+        std::string_view m_bytes;
+    };
+
+    inline auto truncated_cache_entry() -> error_info {
+        return error_info(std::make_error_code(std::errc::illegal_byte_sequence), "Truncated parse cache entry");
+    }
+
+    // Stores the parsed input of days that know how to serialize it, so that solving the same input again skips its
+    // text parser. Entries are files named after the day and a hash of the input text, and hold the input size and
+    // hash again to reject collisions. They also hold the build_stamp of the executable that wrote them, and entries
+    // written by another build are parsed again
+    namespace parse_cache {
+        // Creates the directory if needed. Throws std::runtime_error when it cannot be created
+        void enable(std::string_view directory);
+        auto enabled() noexcept -> bool;
+
+        // Loads the parsed input from the cache when it holds an entry for this text, and otherwise parses the text
+        // and stores the result. Failing to store an entry is not an error: the parsed input is returned anyway
+        auto parse(solver const& s, std::string_view text) -> expected<std::shared_ptr<void const>>;
+    }
+}
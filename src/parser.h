@@ -1,7 +1,25 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <string>
 #include <string_view>
 
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define KAB_SCAN_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
 namespace kab_advent {
     template<typename T>
     struct parsed_value {
@@ -30,4 +48,235 @@ namespace kab_advent {
 	inline auto consume_delimiter( std::string_view & line ) -> bool {
 		return consume_char( line, ',' );
 	}
+
+	// Splits the first line off the input, whether or not it is terminated by a newline
+	inline auto consume_line( std::string_view & lines ) -> std::string_view {
+		auto const line_end = lines.find( '\n' );
+		auto const line = lines.substr( 0, line_end );
+		lines.remove_prefix( line_end != std::string_view::npos ? line_end + 1 : lines.size() );
+		return line;
+	}
+
+	namespace detail {
+		constexpr auto scan_block_size = std::size_t{ 64 };
+		constexpr auto max_scan_delimiters = std::size_t{ 4 };
+
+		inline auto count_trailing_zeros( std::uint64_t const mask ) noexcept -> std::size_t {
+#if defined( _MSC_VER ) && defined( _M_X64 )
+			unsigned long index;
+			_BitScanForward64( &index, mask );
+			return index;
+#elif defined( _MSC_VER )
+			unsigned long index;
+			if ( _BitScanForward( &index, static_cast<unsigned long>( mask ) ) ) {
+				return index;
+			}
+			_BitScanForward( &index, static_cast<unsigned long>( mask >> 32 ) );
+			return index + 32;
+#else
+			return static_cast<std::size_t>( __builtin_ctzll( mask ) );
+#endif
+		}
+
+		// Sets bit i of the result when block[i] is one of the delimiters; block must hold scan_block_size bytes
+		inline auto delimiter_mask( char const * block, std::array<char, max_scan_delimiters> const& delimiters ) noexcept -> std::uint64_t {
+#if defined( __AVX2__ )
+			auto mask = std::uint64_t{ 0 };
+			for ( std::size_t half = 0; half < scan_block_size; half += 32 ) {
+				auto const bytes = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( block + half ) );
+				auto matches = _mm256_setzero_si256();
+				for ( auto const delimiter : delimiters ) {
+					matches = _mm256_or_si256( matches, _mm256_cmpeq_epi8( bytes, _mm256_set1_epi8( delimiter ) ) );
+				}
+				mask |= std::uint64_t{ static_cast<std::uint32_t>( _mm256_movemask_epi8( matches ) ) } << half;
+			}
+			return mask;
+#elif defined( KAB_SCAN_SSE2 )
+			auto mask = std::uint64_t{ 0 };
+			for ( std::size_t quarter = 0; quarter < scan_block_size; quarter += 16 ) {
+				auto const bytes = _mm_loadu_si128( reinterpret_cast<__m128i const*>( block + quarter ) );
+				auto matches = _mm_setzero_si128();
+				for ( auto const delimiter : delimiters ) {
+					matches = _mm_or_si128( matches, _mm_cmpeq_epi8( bytes, _mm_set1_epi8( delimiter ) ) );
+				}
+				mask |= std::uint64_t{ static_cast<std::uint16_t>( _mm_movemask_epi8( matches ) ) } << quarter;
+			}
+			return mask;
+#else
+			auto mask = std::uint64_t{ 0 };
+			for ( std::size_t i = 0; i < scan_block_size; ++i ) {
+				auto const c = block[i];
+				auto const match = c == delimiters[0] || c == delimiters[1] || c == delimiters[2] || c == delimiters[3];
+				mask |= std::uint64_t{ match } << i;
+			}
+			return mask;
+#endif
+		}
+	}
+
+	// Reports the offset of every delimiter in a text, in order. The text is classified a block of 64 bytes at a
+	// time with SSE2 or AVX2 where the compiler targets them, so parsers pay one vector compare per block instead
+	// of one branch per character
+	class delimiter_scanner {
+	public:
+		// Up to four delimiters, none of them '\0'
+		delimiter_scanner( std::string_view const text, std::string_view const delimiters ) noexcept
+			: m_text( text ) {
+			for ( std::size_t i = 0; i < m_delimiters.size(); ++i ) {
+				// Unused lanes repeat the first delimiter so that they never add a match of their own
+				m_delimiters[i] = i < delimiters.size() ? delimiters[i] : delimiters.front();
+			}
+		}
+
+		// Offset of the next delimiter, or npos once the text holds no more
+		auto next() noexcept -> std::size_t {
+			while ( m_mask == 0 ) {
+				if ( m_next_block >= m_text.size() ) {
+					return std::string_view::npos;
+				}
+				m_block = m_next_block;
+				m_next_block += detail::scan_block_size;
+				m_mask = scan_block();
+			}
+			auto const offset = m_block + detail::count_trailing_zeros( m_mask );
+			m_mask &= m_mask - 1;
+			return offset;
+		}
+
+	private:
+		auto scan_block() const noexcept -> std::uint64_t {
+			auto const remaining = m_text.size() - m_block;
+			if ( remaining >= detail::scan_block_size ) {
+				return detail::delimiter_mask( m_text.data() + m_block, m_delimiters );
+			}
+			// The last block is copied so that no load reads past the end of the text
+			char tail[detail::scan_block_size] = {};
+			std::memcpy( tail, m_text.data() + m_block, remaining );
+			return detail::delimiter_mask( tail, m_delimiters ) & ( ( std::uint64_t{ 1 } << remaining ) - 1 );
+		}
+
+		std::string_view m_text;
+		std::array<char, detail::max_scan_delimiters> m_delimiters = {};
+		std::size_t m_block = 0;
+		std::size_t m_next_block = 0;
+		std::uint64_t m_mask = 0;
+	};
+
+	// Splits a text into lines like repeated calls to consume_line, with the newlines found by a delimiter_scanner
+	class line_scanner {
+	public:
+		explicit line_scanner( std::string_view const text ) noexcept
+			: m_text( text )
+			, m_newlines( text, "\n" ) {
+		}
+
+		auto empty() const noexcept -> bool {
+			return m_begin >= m_text.size();
+		}
+
+		// Splits the next line off, whether or not it is terminated by a newline
+		auto consume_line() noexcept -> std::string_view {
+			auto const begin = m_begin;
+			auto line_end = m_newlines.next();
+			if ( line_end == std::string_view::npos ) {
+				line_end = m_text.size();
+			}
+			m_begin = line_end + 1;
+			return m_text.substr( begin, line_end - begin );
+		}
+
+	private:
+		std::string_view m_text;
+		delimiter_scanner m_newlines;
+		std::size_t m_begin = 0;
+	};
+
+	// Splits a stream into lines like a line_scanner, reading it through a fixed-size buffer so that lines can be parsed
+	// while the rest of the stream is still arriving. The buffer only grows to fit a line longer than itself.
+	// A line stays valid until the next call to empty or consume_line
+	class stream_line_scanner {
+	public:
+		static constexpr auto default_capacity = std::size_t{ 64 * 1024 };
+
+		explicit stream_line_scanner( std::istream & stream, std::size_t const capacity = default_capacity )
+			: m_stream( stream )
+			, m_buffer( std::max<std::size_t>( capacity, 1 ), '\0' ) {
+		}
+
+		// Waits for the next line, or for the end of the stream
+		auto empty() -> bool {
+			return find_line_end() == std::string_view::npos && m_begin == m_end;
+		}
+
+		auto consume_line() -> std::string_view {
+			auto const line_end = find_line_end();
+			auto const end = line_end != std::string_view::npos ? line_end : m_end;
+			auto const line = std::string_view( m_buffer.data() + m_begin, end - m_begin );
+			m_begin = line_end != std::string_view::npos ? line_end + 1 : m_end;
+			m_scanned = m_begin;
+			m_line_end = std::string_view::npos;
+			return line;
+		}
+
+		// True when reading stopped on an error rather than at the end of the stream
+		auto failed() const -> bool {
+			return m_stream.bad();
+		}
+
+	private:
+		// Returns the offset of the newline ending the next line, reading more of the stream until one arrives.
+		// Returns npos once the stream ends without one
+		auto find_line_end() -> std::size_t {
+			while ( m_line_end == std::string_view::npos ) {
+				auto const* const newline = static_cast<char const*>( std::memchr( m_buffer.data() + m_scanned, '\n', m_end - m_scanned ) );
+				if ( newline != nullptr ) {
+					m_line_end = static_cast<std::size_t>( newline - m_buffer.data() );
+				} else if ( m_ended ) {
+					break;
+				} else {
+					m_scanned = m_end;
+					refill();
+				}
+			}
+			return m_line_end;
+		}
+
+		void refill() {
+			if ( m_begin != 0 ) {
+				std::memmove( m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin );
+				m_end -= m_begin;
+				m_scanned -= m_begin;
+				m_begin = 0;
+			}
+			if ( m_end == m_buffer.size() ) {
+				m_buffer.resize( m_buffer.size() * 2 );
+			}
+
+			// Waits for some input, then takes only what the stream already holds, so that a line is parsed as soon as it
+			// arrives rather than once the whole buffer is full
+			auto* const source = m_stream.rdbuf();
+			if ( source == nullptr ) {
+				m_stream.setstate( std::ios::badbit );
+				m_ended = true;
+				return;
+			}
+			if ( std::istream::traits_type::eq_int_type( source->sgetc(), std::istream::traits_type::eof() ) ) {
+				m_stream.setstate( std::ios::eofbit );
+				m_ended = true;
+				return;
+			}
+			auto const space = static_cast<std::streamsize>( m_buffer.size() - m_end );
+			auto const available = std::max<std::streamsize>( source->in_avail(), 1 );
+			m_end += static_cast<std::size_t>( source->sgetn( m_buffer.data() + m_end, std::min( available, space ) ) );
+		}
+
+		std::istream & m_stream;
+		std::string m_buffer;
+		std::size_t m_begin = 0;
+		std::size_t m_end = 0;
+		// The unconsumed text before it holds no newline
+		std::size_t m_scanned = 0;
+		std::size_t m_line_end = std::string_view::npos;
+		bool m_ended = false;
+	};
 }
@@ -0,0 +1,129 @@
+#include "perf_counters.h"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace kab_advent {
+    auto perf_counter_name(perf_counter c) noexcept -> char const* {
+        switch(c) {
+            case perf_counter::cycles: return "cycles";
+            case perf_counter::instructions: return "instructions";
+            case perf_counter::cache_misses: return "cache misses";
+            case perf_counter::branch_misses: return "branch misses";
+        }
+        return "unknown";
+    }
+
+#if defined(__linux__)
+    namespace {
+        auto open_counter(std::uint64_t config, int group_fd) noexcept -> int {
+            auto attr = perf_event_attr();
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = config;
+            attr.disabled = group_fd == -1 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+        }
+
+        // One counter group per thread, so that all of its counters cover exactly the same instructions
+        class counter_group {
+        public:
+            counter_group() noexcept {
+                constexpr std::uint64_t configs[perf_counter_count] = {
+                    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+                };
+                for(std::size_t i = 0; i < perf_counter_count; ++i) {
+                    auto const fd = open_counter(configs[i], m_leader);
+                    if(fd == -1) {
+                        if(m_leader == -1) {
+                            m_error = errno;
+                        }
+                        continue;
+                    }
+                    if(m_leader == -1) {
+                        m_leader = fd;
+                    }
+                    m_fds[m_count] = fd;
+                    m_indices[m_count] = i;
+                    ++m_count;
+                }
+
+                if(m_leader != -1) {
+                    ::ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                    ::ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+                }
+            }
+            counter_group(counter_group const&) = delete;
+            auto operator=(counter_group const&) -> counter_group & = delete;
+            ~counter_group() {
+                for(std::size_t i = 0; i < m_count; ++i) {
+                    ::close(m_fds[i]);
+                }
+            }
+
+            auto read() const noexcept -> perf_sample {
+                auto sample = perf_sample{{}, 0};
+                if(m_leader == -1) {
+                    return sample;
+                }
+
+                std::uint64_t buffer[1 + perf_counter_count] = {};
+                if(::read(m_leader, buffer, sizeof(buffer)) <= 0) {
+                    return sample;
+                }
+                for(std::size_t i = 0; i < m_count && i < buffer[0]; ++i) {
+                    sample.values[m_indices[i]] = buffer[1 + i];
+                    sample.mask |= 1u << m_indices[i];
+                }
+                return sample;
+            }
+
+            auto error() const noexcept -> int {
+                return m_leader == -1 ? m_error : 0;
+            }
+
+        private:
+            int m_leader = -1;
+            int m_error = 0;
+            std::size_t m_count = 0;
+            int m_fds[perf_counter_count] = {};
+            std::size_t m_indices[perf_counter_count] = {};
+        };
+
+        auto thread_counters() noexcept -> counter_group const& {
+            thread_local auto const group = counter_group();
+            return group;
+        }
+    }
+
+    auto read_perf_counters() noexcept -> perf_sample {
+        return thread_counters().read();
+    }
+
+    auto perf_counters_error() -> std::string {
+        auto const error = thread_counters().error();
+        if(error == 0) {
+            return {};
+        }
+        return std::string("perf_event_open failed: ").append(std::strerror(error));
+    }
+#else
+    auto read_perf_counters() noexcept -> perf_sample {
+        return perf_sample{{}, 0};
+    }
+
+    auto perf_counters_error() -> std::string {
+        return "Hardware counters are only supported on Linux";
+    }
+#endif
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace kab_advent {
+    enum class perf_counter {
+        cycles,
+        instructions,
+        cache_misses,
+        branch_misses,
+    };
+    constexpr auto perf_counter_count = std::size_t{4};
+
+    auto perf_counter_name(perf_counter c) noexcept -> char const*;
+
+    // Counter values of one thread. Counters the hardware or kernel cannot provide are left out of mask
+    struct perf_sample {
+        std::array<std::uint64_t, perf_counter_count> values;
+        unsigned mask;
+    };
+
+    // Hardware performance counters of the calling thread, counted in user space only. On Linux they are
+    // opened through perf_event_open the first time a thread reads them, elsewhere no counter is available
+    auto read_perf_counters() noexcept -> perf_sample;
+
+    // Explains why no counter could be opened on the calling thread, empty if at least one could
+    auto perf_counters_error() -> std::string;
+}
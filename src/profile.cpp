@@ -0,0 +1,286 @@
+#include "profile.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace kab_advent {
+    namespace profile {
+        auto phase_name(phase p) noexcept -> char const* {
+            switch(p) {
+                case phase::input: return "input";
+                case phase::parse: return "parse";
+                case phase::solve: return "solve";
+                case phase::output: return "output";
+            }
+            return "unknown";
+        }
+
+#if KAB_PROFILING
+        namespace {
+            struct phase_totals {
+                std::atomic<std::int64_t> calls{0};
+                std::atomic<std::int64_t> total_ns{0};
+                std::atomic<std::int64_t> max_ns{0};
+                std::atomic<std::int64_t> allocations{0};
+                std::atomic<std::int64_t> allocated_bytes{0};
+                std::atomic<std::int64_t> peak_live_bytes{0};
+            };
+
+            std::array<phase_totals, phase_count> totals;
+
+            struct trace_event {
+                phase p;
+                char type;
+                std::chrono::steady_clock::time_point time;
+                int thread;
+                detail::job_tag job;
+            };
+
+            // Events are only recorded when a phase ends, so a shared buffer sees little contention
+            struct trace_buffer {
+                std::atomic<bool> enabled{false};
+                std::chrono::steady_clock::time_point epoch;
+                std::mutex mutex;
+                std::vector<trace_event> events;
+            };
+
+            trace_buffer trace;
+            thread_local detail::job_tag current_job = {0, 0};
+
+            // Small sequential ids read better in a trace viewer than native thread ids
+            auto trace_thread_id() noexcept -> int {
+                static auto next_id = std::atomic<int>{0};
+                thread_local auto const id = ++next_id;
+                return id;
+            }
+
+            void record_trace(phase p, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) noexcept {
+                auto const thread = trace_thread_id();
+                try {
+                    auto const lock = std::lock_guard<std::mutex>(trace.mutex);
+                    trace.events.push_back({p, 'B', start, thread, current_job});
+                    trace.events.push_back({p, 'E', end, thread, current_job});
+                } catch(std::bad_alloc const&) {
+                    // Dropping events is better than failing the run being traced
+                }
+            }
+
+            struct counter_totals {
+                std::int64_t calls = 0;
+                std::array<std::uint64_t, perf_counter_count> values = {};
+                unsigned mask = ~0u;
+            };
+
+            struct counter_buffer {
+                std::atomic<bool> enabled{false};
+                std::mutex mutex;
+                std::map<std::pair<int, int>, counter_totals> jobs;
+            };
+
+            counter_buffer counters;
+
+            void record_counters(perf_sample const& start, perf_sample const& end) noexcept {
+                try {
+                    auto const lock = std::lock_guard<std::mutex>(counters.mutex);
+                    auto & totals = counters.jobs[{current_job.day, current_job.part}];
+                    ++totals.calls;
+                    for(std::size_t i = 0; i < perf_counter_count; ++i) {
+                        totals.values[i] += end.values[i] - start.values[i];
+                    }
+                    totals.mask &= start.mask & end.mask;
+                } catch(std::bad_alloc const&) {
+                    // Dropping samples is better than failing the run being measured
+                }
+            }
+
+            // Runs the profiler's own bookkeeping once a phase has been sampled, keeping what it allocates out of the
+            // heap figures of the phase and of the phases around it
+            template<typename F>
+            void untracked(F const& f) noexcept {
+                auto const outer = detail::heap;
+                detail::heap.phase = -1;
+                f();
+                detail::heap = outer;
+            }
+
+            void store_max(std::atomic<std::int64_t> & target, std::int64_t const value) noexcept {
+                auto current = target.load(std::memory_order_relaxed);
+                while(value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+                }
+            }
+        }
+
+        namespace detail {
+            auto enter(phase p) noexcept -> phase_mark {
+                auto mark = phase_mark{heap.phase, heap.live_bytes, heap.peak_bytes, perf_sample{{}, 0}};
+                // The first read on a thread sets up its counters, which allocates
+                if(p == phase::solve && counters.enabled.load(std::memory_order_relaxed)) {
+                    untracked([&mark] { mark.counters = read_perf_counters(); });
+                }
+                heap.phase = static_cast<int>(p);
+                heap.peak_bytes = heap.live_bytes;
+                return mark;
+            }
+
+            auto leave(phase p, phase_mark const& mark, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) noexcept -> phase_sample {
+                auto const counting = p == phase::solve && counters.enabled.load(std::memory_order_relaxed);
+                auto const counters_end = counting ? read_perf_counters() : perf_sample{{}, 0};
+
+                auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+                auto & t = totals[static_cast<std::size_t>(p)];
+                t.calls.fetch_add(1, std::memory_order_relaxed);
+                t.total_ns.fetch_add(ns, std::memory_order_relaxed);
+                store_max(t.max_ns, ns);
+                auto const sample = phase_sample{ns, heap.peak_bytes - mark.live_bytes, heap.live_bytes - mark.live_bytes};
+                store_max(t.peak_live_bytes, sample.peak_bytes);
+
+                if(counting) {
+                    untracked([&mark, &counters_end] { record_counters(mark.counters, counters_end); });
+                }
+                if(trace.enabled.load(std::memory_order_relaxed)) {
+                    untracked([p, start, end] { record_trace(p, start, end); });
+                }
+
+                heap.phase = mark.outer_phase;
+                heap.peak_bytes = std::max(mark.peak_bytes, heap.peak_bytes);
+                return sample;
+            }
+
+            auto exchange_job(job_tag job) noexcept -> job_tag {
+                return std::exchange(current_job, job);
+            }
+        }
+
+        void enable_trace() noexcept {
+            trace.epoch = std::chrono::steady_clock::now();
+            trace.enabled.store(true, std::memory_order_relaxed);
+            enable();
+        }
+
+#if KAB_TRACK_ALLOCATIONS
+        namespace detail {
+            void track_allocation(std::size_t const size) noexcept {
+                auto const bytes = static_cast<std::int64_t>(size);
+                heap.live_bytes += bytes;
+                heap.peak_bytes = std::max(heap.peak_bytes, heap.live_bytes);
+                if(heap.phase >= 0) {
+                    auto & t = totals[static_cast<std::size_t>(heap.phase)];
+                    t.allocations.fetch_add(1, std::memory_order_relaxed);
+                    t.allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+                }
+            }
+
+            void track_deallocation(std::size_t const size) noexcept {
+                heap.live_bytes -= static_cast<std::int64_t>(size);
+            }
+        }
+#endif
+
+        void report(std::ostream & o) {
+            auto const ms = [] (std::int64_t ns) { return static_cast<double>(ns) / 1e6; };
+            auto all_ns = std::int64_t{0};
+            for(auto const& t : totals) {
+                all_ns += t.total_ns.load(std::memory_order_relaxed);
+            }
+            o << "phase       calls    total (ms)     mean (ms)      max (ms)   share     allocs       bytes   peak bytes\n";
+            for(std::size_t i = 0; i < phase_count; ++i) {
+                auto const& t = totals[i];
+                auto const calls = t.calls.load(std::memory_order_relaxed);
+                auto const total_ns = t.total_ns.load(std::memory_order_relaxed);
+                o << std::left << std::setw(8) << phase_name(static_cast<phase>(i)) << std::right
+                    << std::setw(8) << calls
+                    << std::fixed << std::setprecision(3)
+                    << std::setw(14) << ms(total_ns)
+                    << std::setw(14) << (calls == 0 ? 0.0 : ms(total_ns) / static_cast<double>(calls))
+                    << std::setw(14) << ms(t.max_ns.load(std::memory_order_relaxed))
+                    << std::setprecision(1) << std::setw(7) << (all_ns == 0 ? 0.0 : 100.0 * static_cast<double>(total_ns) / static_cast<double>(all_ns)) << "%";
+#if KAB_TRACK_ALLOCATIONS
+                o << std::setw(11) << t.allocations.load(std::memory_order_relaxed)
+                    << std::setw(12) << t.allocated_bytes.load(std::memory_order_relaxed)
+                    << std::setw(13) << t.peak_live_bytes.load(std::memory_order_relaxed);
+#else
+                o << std::setw(11) << '-' << std::setw(12) << '-' << std::setw(13) << '-';
+#endif
+                o << "\n";
+            }
+        }
+
+        void enable_counters() noexcept {
+            counters.enabled.store(true, std::memory_order_relaxed);
+            enable();
+        }
+
+        void report_counters(std::ostream & o) {
+            auto const error = perf_counters_error();
+            if(!error.empty()) {
+                o << "Hardware counters unavailable: " << error << "\n";
+                return;
+            }
+
+            auto const lock = std::lock_guard<std::mutex>(counters.mutex);
+            o << "day part   calls          cycles    instructions     IPC    cache misses   branch misses\n";
+            for(auto const& [job, totals] : counters.jobs) {
+                auto const has = [&totals] (perf_counter c) { return (totals.mask & (1u << static_cast<unsigned>(c))) != 0; };
+                auto const value = [&totals] (perf_counter c) { return totals.values[static_cast<std::size_t>(c)]; };
+                auto const write_value = [&o, &has, &value] (perf_counter c) {
+                    if(has(c)) {
+                        o << std::setw(16) << value(c);
+                    } else {
+                        o << std::setw(16) << '-';
+                    }
+                };
+
+                o << std::setw(3) << job.first << std::setw(5) << job.second << std::setw(8) << totals.calls;
+                write_value(perf_counter::cycles);
+                write_value(perf_counter::instructions);
+                if(has(perf_counter::cycles) && has(perf_counter::instructions) && value(perf_counter::cycles) != 0) {
+                    o << std::setw(8) << std::fixed << std::setprecision(2)
+                        << static_cast<double>(value(perf_counter::instructions)) / static_cast<double>(value(perf_counter::cycles));
+                } else {
+                    o << std::setw(8) << '-';
+                }
+                write_value(perf_counter::cache_misses);
+                write_value(perf_counter::branch_misses);
+                o << "\n";
+            }
+        }
+
+        void write_trace(std::ostream & o) {
+            auto const lock = std::lock_guard<std::mutex>(trace.mutex);
+            o << "{\"traceEvents\":[";
+            for(auto const& e : trace.events) {
+                auto const us = std::chrono::duration<double, std::micro>(e.time - trace.epoch).count();
+                o << (&e == trace.events.data() ? "\n" : ",\n")
+                    << "{\"name\":\"" << phase_name(e.p) << "\",\"cat\":\"phase\",\"ph\":\"" << e.type << "\""
+                    << ",\"ts\":" << std::fixed << std::setprecision(3) << us << ",\"pid\":1,\"tid\":" << e.thread;
+                if(e.job.day != 0) {
+                    o << ",\"args\":{\"day\":" << e.job.day << ",\"part\":" << e.job.part << "}";
+                }
+                o << "}";
+            }
+            o << "\n],\"displayTimeUnit\":\"ms\"}\n";
+        }
+#else
+        void report(std::ostream & o) {
+            o << "Profiling was compiled out of this build (KAB_PROFILING=0)\n";
+        }
+
+        void write_trace(std::ostream & o) {
+            o << "{\"traceEvents\":[]}\n";
+        }
+
+        void report_counters(std::ostream & o) {
+            o << "Hardware counters were compiled out of this build (KAB_PROFILING=0)\n";
+        }
+#endif
+    }
+}
+
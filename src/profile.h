@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+#include "perf_counters.h"
+
+// Phase instrumentation for --profile, --trace and --counters. Building with KAB_PROFILING=0 compiles every probe down to nothing
+#ifndef KAB_PROFILING
+#define KAB_PROFILING 1
+#endif
+
+// Heap traffic is counted by replacing the global operator new and delete (see allocation_hooks.cpp), where the
+// allocator can report the size of a block so that no header has to be added to each allocation
+#if KAB_PROFILING && (defined(_WIN32) || defined(__GLIBC__) || defined(__APPLE__))
+#define KAB_TRACK_ALLOCATIONS 1
+#else
+#define KAB_TRACK_ALLOCATIONS 0
+#endif
+
+namespace kab_advent {
+    namespace profile {
+        enum class phase {
+            input,   // Reading the puzzle input
+            parse,   // Turning the input text into the day's parsed input
+            solve,   // Running one part on the parsed input
+            output,  // Formatting and writing the answer
+        };
+        constexpr auto phase_count = std::size_t{4};
+
+        auto phase_name(phase p) noexcept -> char const*;
+
+        // Cost of one call of a phase on the calling thread. Heap figures are relative to the heap use when the phase
+        // was entered, and stay 0 when allocations are not tracked
+        struct phase_sample {
+            std::int64_t ns = 0;
+            std::int64_t peak_bytes = 0;
+            // Still allocated when the phase was left, such as a parsed input
+            std::int64_t retained_bytes = 0;
+        };
+
+#if KAB_PROFILING
+        namespace detail {
+            inline std::atomic<bool> enabled{false};
+        }
+
+        inline void enable() noexcept {
+            detail::enabled.store(true, std::memory_order_relaxed);
+        }
+
+        inline auto enabled() noexcept -> bool {
+            return detail::enabled.load(std::memory_order_relaxed);
+        }
+
+        // Also records a begin and an end trace event for every phase from now on
+        void enable_trace() noexcept;
+        // Also samples hardware performance counters around every solve phase from now on
+        void enable_counters() noexcept;
+
+        namespace detail {
+            // Heap state of the calling thread when a phase was entered, restored when it is left
+            struct phase_mark {
+                int outer_phase;
+                std::int64_t live_bytes;
+                std::int64_t peak_bytes;
+                perf_sample counters;
+            };
+
+            auto enter(phase p) noexcept -> phase_mark;
+            // Safe to call from several threads, the totals of a phase are summed over all of them
+            auto leave(phase p, phase_mark const& mark, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) noexcept -> phase_sample;
+
+            struct job_tag {
+                int day;
+                int part;
+            };
+
+            auto exchange_job(job_tag job) noexcept -> job_tag;
+
+            // Heap traffic of the current thread. Live bytes go negative when a thread frees memory allocated by another
+            struct heap_state {
+                int phase = -1;
+                std::int64_t live_bytes = 0;
+                std::int64_t peak_bytes = 0;
+            };
+
+            inline thread_local heap_state heap;
+
+#if KAB_TRACK_ALLOCATIONS
+            // Charges a heap block allocated or freed by the calling thread to its current phase
+            void track_allocation(std::size_t size) noexcept;
+            void track_deallocation(std::size_t size) noexcept;
+#endif
+        }
+
+        // Writes the per-phase breakdown collected so far
+        void report(std::ostream & o);
+        // Writes the recorded trace events as Chrome trace-event JSON
+        void write_trace(std::ostream & o);
+        // Writes the hardware counters of the solve phases, per day and part
+        void report_counters(std::ostream & o);
+
+        // Tags the trace events of phases entered by this thread with the day and part being solved
+        class scoped_job {
+        public:
+            scoped_job(int day, int part) noexcept
+                : m_outer(detail::exchange_job({day, part})) {
+            }
+            scoped_job(scoped_job const&) = delete;
+            auto operator=(scoped_job const&) -> scoped_job & = delete;
+            ~scoped_job() {
+                detail::exchange_job(m_outer);
+            }
+
+        private:
+            detail::job_tag m_outer;
+        };
+
+        // Times its own lifetime as one call of the phase, when profiling is enabled.
+        // Heap allocations made by the thread meanwhile are charged to the phase
+        class scoped_phase {
+        public:
+            explicit scoped_phase(phase p) noexcept
+                : scoped_phase(p, nullptr) {
+            }
+            // Also stores the measurements of this call in *sample when it is not null
+            scoped_phase(phase p, phase_sample * sample) noexcept
+                : m_phase(p)
+                , m_active(enabled())
+                , m_sample(sample) {
+                if(m_active) {
+                    m_mark = detail::enter(p);
+                    m_start = std::chrono::steady_clock::now();
+                }
+            }
+            scoped_phase(scoped_phase const&) = delete;
+            auto operator=(scoped_phase const&) -> scoped_phase & = delete;
+            ~scoped_phase() {
+                if(m_active) {
+                    auto const sample = detail::leave(m_phase, m_mark, m_start, std::chrono::steady_clock::now());
+                    if(m_sample != nullptr) {
+                        *m_sample = sample;
+                    }
+                }
+            }
+
+        private:
+            phase m_phase;
+            bool m_active;
+            phase_sample * m_sample;
+            detail::phase_mark m_mark = {};
+            std::chrono::steady_clock::time_point m_start;
+        };
+
+        // Heap use of work a thread hands to helper threads, such as the chunks of a parallel parse. Helpers charge
+        // their allocations to the phase of the thread that made the share, and that thread takes over their heap
+        // use in merge, along with the blocks they leave it to free. Helpers do not necessarily peak at the same
+        // time, so the peak they add is an upper bound
+        class heap_share {
+        public:
+            heap_share() noexcept
+                : m_phase(detail::heap.phase) {
+            }
+            heap_share(heap_share const&) = delete;
+            auto operator=(heap_share const&) -> heap_share & = delete;
+
+            // Charges the heap use of the calling helper thread to the share for its lifetime
+            class scoped_helper {
+            public:
+                explicit scoped_helper(heap_share & share) noexcept
+                    : m_share(share)
+                    , m_outer(detail::heap) {
+                    detail::heap.phase = share.m_phase;
+                    detail::heap.peak_bytes = detail::heap.live_bytes;
+                }
+                scoped_helper(scoped_helper const&) = delete;
+                auto operator=(scoped_helper const&) -> scoped_helper & = delete;
+                ~scoped_helper() {
+                    m_share.m_peak_bytes.fetch_add(detail::heap.peak_bytes - m_outer.live_bytes, std::memory_order_relaxed);
+                    m_share.m_retained_bytes.fetch_add(detail::heap.live_bytes - m_outer.live_bytes, std::memory_order_relaxed);
+                    detail::heap = m_outer;
+                }
+
+            private:
+                heap_share & m_share;
+                detail::heap_state m_outer;
+            };
+
+            // Called by the thread that made the share, once every helper is done
+            void merge() noexcept {
+                auto & heap = detail::heap;
+                heap.peak_bytes = std::max(heap.peak_bytes, heap.live_bytes + m_peak_bytes.load(std::memory_order_relaxed));
+                heap.live_bytes += m_retained_bytes.load(std::memory_order_relaxed);
+            }
+
+        private:
+            int m_phase;
+            std::atomic<std::int64_t> m_peak_bytes{0};
+            std::atomic<std::int64_t> m_retained_bytes{0};
+        };
+#else
+        inline void enable() noexcept {}
+        constexpr auto enabled() noexcept -> bool { return false; }
+        inline void enable_trace() noexcept {}
+        inline void enable_counters() noexcept {}
+        void report(std::ostream & o);
+        void write_trace(std::ostream & o);
+        void report_counters(std::ostream & o);
+
+        class scoped_job {
+        public:
+            constexpr scoped_job(int, int) noexcept {}
+            // User-provided so that unused scopes do not warn
+            ~scoped_job() {}
+        };
+
+        class heap_share {
+        public:
+            class scoped_helper {
+            public:
+                explicit constexpr scoped_helper(heap_share &) noexcept {}
+                // User-provided so that unused scopes do not warn
+                ~scoped_helper() {}
+            };
+
+            constexpr void merge() noexcept {}
+        };
+
+        class scoped_phase {
+        public:
+            explicit constexpr scoped_phase(phase) noexcept {}
+            constexpr scoped_phase(phase, phase_sample *) noexcept {}
+            // User-provided so that unused scopes do not warn
+            ~scoped_phase() {}
+        };
+#endif
+    }
+}
@@ -0,0 +1,274 @@
+#include "result_cache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <variant>
+#include <vector>
+
+#include "algorithm.h"
+#include "input.h"
+
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace kab_advent::result_cache {
+    namespace {
+        using namespace std::literals;
+
+        constexpr auto format_version = std::uint32_t{2};
+        constexpr char magic[4] = {'K', 'A', 'B', 'R'};
+        constexpr auto entry_extension = std::string_view(".result");
+
+        enum class answer_kind : std::uint32_t {
+            integer,
+            text,
+        };
+
+        struct entry_header {
+            char magic[4];
+            std::uint32_t version;
+            std::uint32_t day;
+            std::uint32_t part;
+            std::uint64_t text_size;
+            std::uint64_t text_hash;
+            std::uint64_t build;
+            answer_kind kind;
+            std::uint32_t payload_size;
+        };
+
+        enum class cache_state {
+            unresolved,
+            enabled,
+            disabled,
+        };
+
+        // Set by main before any solver runs. The default directory is resolved by the first lookup, which may
+        // happen on any thread of the server
+        auto state = cache_state::unresolved;
+        auto cache_directory = std::filesystem::path();
+        auto resolved = std::once_flag();
+
+        // The per-user cache root: %LOCALAPPDATA% on Windows, otherwise $XDG_CACHE_HOME or ~/.cache. Empty when the
+        // environment names none of them
+        auto user_cache_root() -> std::filesystem::path {
+#if defined(_WIN32)
+            if(auto const* const local = std::getenv("LOCALAPPDATA"); local != nullptr && *local != '\0') {
+                return local;
+            }
+#else
+            if(auto const* const xdg = std::getenv("XDG_CACHE_HOME"); xdg != nullptr && *xdg == '/') {
+                return xdg;
+            }
+            if(auto const* const home = std::getenv("HOME"); home != nullptr && *home == '/') {
+                return std::filesystem::path(home) / ".cache";
+            }
+#endif
+            return {};
+        }
+
+        // Cached answers are returned without solving again, so the default directory must be one no other user can
+        // write to. It is created private, and an existing one is refused unless it is a real directory owned by
+        // this user that neither group nor others can write to
+        auto make_private_directory(std::filesystem::path const& path) -> bool {
+            auto ec = std::error_code();
+            std::filesystem::create_directories(path.parent_path(), ec);
+#if defined(_WIN32)
+            std::filesystem::create_directory(path, ec);
+            return !ec && std::filesystem::is_directory(path, ec);
+#else
+            if(::mkdir(path.c_str(), 0700) != 0 && errno != EEXIST) {
+                return false;
+            }
+            struct stat info;
+            return ::lstat(path.c_str(), &info) == 0
+                && S_ISDIR(info.st_mode)
+                && info.st_uid == ::geteuid()
+                && (info.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+#endif
+        }
+
+        auto directory() -> std::filesystem::path const* {
+            std::call_once(resolved, [] {
+                if(state != cache_state::unresolved) {
+                    return;
+                }
+                auto const root = user_cache_root();
+                auto path = root / "kab_advent" / "results";
+                state = !root.empty() && make_private_directory(path) ? cache_state::enabled : cache_state::disabled;
+                cache_directory = std::move(path);
+            });
+            return state == cache_state::enabled ? &cache_directory : nullptr;
+        }
+
+        auto entry_path(std::filesystem::path const& dir, entry_key const& key) -> std::filesystem::path {
+            char name[64];
+            std::snprintf(name, sizeof(name), "day%02d-part%d-%016llx", key.day, key.part, static_cast<unsigned long long>(key.text_hash));
+            return dir / std::string(name).append(entry_extension);
+        }
+
+        auto matches(entry_header const& header, entry_key const& key) noexcept -> bool {
+            return std::memcmp(header.magic, magic, sizeof(magic)) == 0
+                && header.version == format_version
+                && header.day == static_cast<std::uint32_t>(key.day)
+                && header.part == static_cast<std::uint32_t>(key.part)
+                && header.text_size == key.text_size
+                && header.text_hash == key.text_hash
+                && header.build == key.build;
+        }
+
+        struct stored_entry {
+            std::filesystem::path path;
+            std::filesystem::file_time_type last_used;
+            std::uintmax_t size;
+        };
+
+        // Removes the least recently used entries until the cache is back within both of its bounds
+        void evict(std::filesystem::path const& dir) {
+            auto entries = std::vector<stored_entry>();
+            auto total_size = std::uintmax_t{0};
+            auto ec = std::error_code();
+            for(auto it = std::filesystem::directory_iterator(dir, ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+                if(it->path().extension() != entry_extension) {
+                    continue;
+                }
+                auto entry_ec = std::error_code();
+                auto const size = it->file_size(entry_ec);
+                auto const last_used = it->last_write_time(entry_ec);
+                if(!entry_ec) {
+                    entries.push_back(stored_entry{it->path(), last_used, size});
+                    total_size += size;
+                }
+            }
+            if(entries.size() <= max_entries && total_size <= max_bytes) {
+                return;
+            }
+
+            std::sort(entries.begin(), entries.end(), [] (stored_entry const& lhs, stored_entry const& rhs) {
+                return lhs.last_used < rhs.last_used;
+            });
+            auto count = entries.size();
+            for(auto const& entry : entries) {
+                if(count <= max_entries && total_size <= max_bytes) {
+                    break;
+                }
+                if(std::filesystem::remove(entry.path, ec)) {
+                    --count;
+                    total_size -= entry.size;
+                }
+            }
+        }
+    }
+
+    void disable() noexcept {
+        state = cache_state::disabled;
+    }
+
+    void set_directory(std::string_view dir) {
+        auto path = std::filesystem::path(dir);
+        auto ec = std::error_code();
+        std::filesystem::create_directories(path, ec);
+        if(ec || !std::filesystem::is_directory(path, ec)) {
+            throw std::runtime_error("Could not create cache directory \""s.append(dir).append("\""));
+        }
+        cache_directory = std::move(path);
+        state = cache_state::enabled;
+    }
+
+    auto make_key(int day, int part, std::string_view text) noexcept -> entry_key {
+        return entry_key{day, part, text.size(), hash_bytes(text), build_stamp()};
+    }
+
+    auto lookup(entry_key const& key) -> std::optional<answer> {
+        auto const* const dir = directory();
+        if(dir == nullptr || key.build == 0) {
+            return std::nullopt;
+        }
+
+        auto const path = entry_path(*dir, key);
+        auto file = std::ifstream(path, std::ios::binary);
+        auto header = entry_header();
+        if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || !matches(header, key) || header.payload_size > max_bytes) {
+            return std::nullopt;
+        }
+
+        auto payload = std::string(header.payload_size, '\0');
+        if(!file.read(payload.data(), static_cast<std::streamsize>(payload.size())) || file.peek() != std::ifstream::traits_type::eof()) {
+            return std::nullopt;
+        }
+        file.close();
+
+        auto result = std::optional<answer>();
+        if(header.kind == answer_kind::integer && payload.size() == sizeof(std::int64_t)) {
+            auto value = std::int64_t{0};
+            std::memcpy(&value, payload.data(), sizeof(value));
+            result = answer(value);
+        } else if(header.kind == answer_kind::text) {
+            result = answer(std::move(payload));
+        } else {
+            return std::nullopt;
+        }
+
+        auto ec = std::error_code();
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+        return result;
+    }
+
+    void store(entry_key const& key, answer const& a, std::chrono::nanoseconds const solve_time) {
+        auto const* const dir = directory();
+        if(dir == nullptr || key.build == 0 || solve_time < min_solve_time) {
+            return;
+        }
+
+        auto payload = std::string();
+        auto header = entry_header();
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = format_version;
+        header.day = static_cast<std::uint32_t>(key.day);
+        header.part = static_cast<std::uint32_t>(key.part);
+        header.text_size = key.text_size;
+        header.text_hash = key.text_hash;
+        header.build = key.build;
+        if(auto const* const value = std::get_if<std::int64_t>(&a)) {
+            header.kind = answer_kind::integer;
+            payload.assign(reinterpret_cast<char const*>(value), sizeof(*value));
+        } else {
+            header.kind = answer_kind::text;
+            payload = std::get<std::string>(a);
+        }
+        header.payload_size = static_cast<std::uint32_t>(payload.size());
+        payload.insert(0, reinterpret_cast<char const*>(&header), sizeof(header));
+
+        if(replace_file(entry_path(*dir, key).string(), payload)) {
+            evict(*dir);
+        }
+    }
+
+    auto solve(solver const& s, std::string_view text, solve_stats * stats) -> expected<answer> {
+        auto const key = make_key(s.day, s.part, text);
+        if(auto cached = lookup(key)) {
+            if(stats != nullptr) {
+                stats->input_bytes = text.size();
+                stats->cached = true;
+            }
+            return std::move(cached).value();
+        }
+
+        auto const start = std::chrono::steady_clock::now();
+        auto result = run_solver(s, text, stats);
+        if(result) {
+            store(key, result.value(), std::chrono::steady_clock::now() - start);
+        }
+        return result;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "solver.h"
+
+namespace kab_advent {
+    // Remembers answers across runs, keyed by day, part, a hash of the input text and the build that solved it, so that
+    // resubmitting an input only costs reading it. Answers found by another build are solved again, since that build's
+    // solvers may differ. Each answer is a small file in the cache directory. Hits refresh the file's modification
+    // time, and storing an answer evicts the least recently used files once the cache holds more than max_entries
+    // answers or max_bytes bytes
+    namespace result_cache {
+        constexpr auto max_entries = std::size_t{4096};
+        constexpr auto max_bytes = std::uintmax_t{16} * 1024 * 1024;
+        // Answers found faster than this are cheaper to recompute than to store
+        constexpr auto min_solve_time = std::chrono::milliseconds(1);
+
+        struct entry_key {
+            int day;
+            int part;
+            std::uint64_t text_size;
+            std::uint64_t text_hash;
+            // The build_stamp of the executable. 0 when it is unknown, in which case nothing is cached
+            std::uint64_t build;
+        };
+
+        // The cache is on by default, in "kab_advent/results" under the user's cache directory ($XDG_CACHE_HOME or
+        // ~/.cache, %LOCALAPPDATA% on Windows). It turns itself off when that directory cannot be created, or when it
+        // already exists but is not private to the user
+        void disable() noexcept;
+        // Throws std::runtime_error when the directory cannot be created
+        void set_directory(std::string_view directory);
+
+        auto make_key(int day, int part, std::string_view text) noexcept -> entry_key;
+
+        auto lookup(entry_key const& key) -> std::optional<answer>;
+        // Failing to store an answer is not an error, the answer is simply solved again next time
+        void store(entry_key const& key, answer const& a, std::chrono::nanoseconds solve_time);
+
+        // Returns the cached answer for the text, or runs the solver and stores what it finds. Fills stats when not null
+        auto solve(solver const& s, std::string_view text, solve_stats * stats = nullptr) -> expected<answer>;
+    }
+}
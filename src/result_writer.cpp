@@ -0,0 +1,149 @@
+#include "result_writer.h"
+
+#include <atomic>
+#include <charconv>
+#include <variant>
+
+namespace kab_advent {
+    namespace {
+        using namespace std::literals;
+
+        std::atomic<output_format> chosen_format{output_format::text};
+
+        void append_integer_to(std::string & out, std::int64_t const value) {
+            char digits[24];
+            auto const result = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, static_cast<std::size_t>(result.ptr - digits));
+        }
+    }
+
+    void set_output_format(output_format const format) noexcept {
+        chosen_format.store(format, std::memory_order_relaxed);
+    }
+
+    auto get_output_format() noexcept -> output_format {
+        return chosen_format.load(std::memory_order_relaxed);
+    }
+
+    void append_answer(std::string & out, answer const& a) {
+        if(auto const* const value = std::get_if<std::int64_t>(&a)) {
+            append_integer_to(out, *value);
+        } else {
+            out.append(std::get<std::string>(a));
+        }
+    }
+
+    result_writer::result_writer(std::ostream & out, output_format const format, std::size_t const capacity)
+        : m_out(out)
+        , m_format(format)
+        , m_capacity(capacity) {
+        // Room for a final record past the capacity, so that the common record never reallocates
+        m_buffer.reserve(capacity + 256);
+    }
+
+    result_writer::~result_writer() {
+        flush();
+    }
+
+    void result_writer::write(int const day, int const part, expected<answer> const& result, solve_stats const* const stats) {
+        if(m_format != output_format::text) {
+            m_buffer.append("{\"day\":"sv);
+            append_integer(day);
+            m_buffer.append(",\"part\":"sv);
+            append_integer(part);
+            if(!result) {
+                m_buffer.append(",\"error\":\""sv);
+                append_json_string(result.error().get_error_code().message());
+                if(result.error().has_error_message()) {
+                    m_buffer.append(": "sv);
+                    result.error().format_message([this] (std::string_view const piece) { append_json_string(piece); });
+                }
+                m_buffer.push_back('"');
+            } else if(auto const* const value = std::get_if<std::int64_t>(&result.value())) {
+                m_buffer.append(",\"answer\":"sv);
+                append_integer(*value);
+            } else {
+                m_buffer.append(",\"answer\":\""sv);
+                append_json_string(std::get<std::string>(result.value()));
+                m_buffer.push_back('"');
+            }
+            if(m_format == output_format::metrics) {
+                append_stats(stats != nullptr ? *stats : solve_stats());
+            }
+            m_buffer.push_back('}');
+        } else {
+            append_integer(day);
+            m_buffer.push_back(' ');
+            append_integer(part);
+            m_buffer.push_back(' ');
+            if(!result) {
+                m_buffer.append("error: "sv).append(result.error().get_error_code().message());
+                if(result.error().has_error_message()) {
+                    m_buffer.append(": "sv);
+                    result.error().format_message([this] (std::string_view const piece) { m_buffer.append(piece); });
+                }
+            } else {
+                append_answer(m_buffer, result.value());
+            }
+        }
+        end_record();
+    }
+
+    void result_writer::append_stats(solve_stats const& stats) {
+        m_buffer.append(",\"parse_ns\":"sv);
+        append_integer(stats.parse.ns);
+        m_buffer.append(",\"solve_ns\":"sv);
+        append_integer(stats.solve.ns);
+        m_buffer.append(",\"peak_bytes\":"sv);
+        append_integer(stats.peak_bytes());
+        m_buffer.append(",\"input_bytes\":"sv);
+        append_integer(static_cast<std::int64_t>(stats.input_bytes));
+        m_buffer.append(stats.cached ? ",\"cached\":true"sv : ",\"cached\":false"sv);
+    }
+
+    void result_writer::write_answer(answer const& a) {
+        append_answer(m_buffer, a);
+        end_record();
+    }
+
+    void result_writer::flush() {
+        if(!m_buffer.empty()) {
+            m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+            m_buffer.clear();
+        }
+        m_out.flush();
+    }
+
+    void result_writer::append_integer(std::int64_t const value) {
+        append_integer_to(m_buffer, value);
+    }
+
+    // Quotes are left to the caller, so that a string can be escaped in pieces
+    void result_writer::append_json_string(std::string_view const s) {
+        constexpr auto hex = "0123456789abcdef"sv;
+        for(auto const c : s) {
+            switch(c) {
+                case '"': m_buffer.append("\\\""sv); break;
+                case '\\': m_buffer.append("\\\\"sv); break;
+                case '\n': m_buffer.append("\\n"sv); break;
+                case '\t': m_buffer.append("\\t"sv); break;
+                default:
+                    if(static_cast<unsigned char>(c) < 0x20) {
+                        m_buffer.append("\\u00"sv);
+                        m_buffer.push_back(hex[static_cast<unsigned char>(c) >> 4]);
+                        m_buffer.push_back(hex[static_cast<unsigned char>(c) & 0xF]);
+                    } else {
+                        m_buffer.push_back(c);
+                    }
+            }
+        }
+    }
+
+    void result_writer::end_record() {
+        m_buffer.push_back('\n');
+        if(m_buffer.size() >= m_capacity) {
+            m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+            m_buffer.clear();
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "error.h"
+#include "solver.h"
+
+// Buffered result output. Records are formatted straight into one preallocated buffer, integers with std::to_chars,
+// and the buffer goes out in a single write whenever it fills up, on flush and on destruction, instead of a chain
+// of iostream calls for every result
+namespace kab_advent {
+    enum class output_format {
+        text,    // "<day> <part> <answer>", or "<day> <part> error: <message>"
+        ndjson,  // One JSON object per line: {"day":1,"part":2,"answer":42}, or {"day":1,"part":2,"error":"..."}
+        // ndjson records that also carry what the run cost: "parse_ns", "solve_ns", "peak_bytes" of heap, "input_bytes"
+        // and "cached", true when the answer came from the result cache without parsing or solving
+        metrics,
+    };
+
+    // Chosen on the command line with --format, text by default
+    void set_output_format(output_format format) noexcept;
+    auto get_output_format() noexcept -> output_format;
+
+    // Appends the answer as text, the way operator<< prints it
+    void append_answer(std::string & out, answer const& a);
+
+    class result_writer {
+    public:
+        static constexpr auto default_capacity = std::size_t{1} << 16;
+
+        result_writer(std::ostream & out, output_format format, std::size_t capacity = default_capacity);
+        result_writer(result_writer const&) = delete;
+        auto operator=(result_writer const&) -> result_writer & = delete;
+        ~result_writer();
+
+        // The stats are only written in metrics format, as zeros when they are null
+        void write(int day, int part, expected<answer> const& result, solve_stats const* stats = nullptr);
+        // Writes the answer alone on its line, as a single day run prints it in text format
+        void write_answer(answer const& a);
+        // Hands everything buffered so far to the stream and flushes it
+        void flush();
+
+        auto format() const noexcept -> output_format { return m_format; }
+
+    private:
+        void append_integer(std::int64_t value);
+        void append_json_string(std::string_view s);
+        void append_stats(solve_stats const& stats);
+        void end_record();
+
+        std::ostream & m_out;
+        output_format m_format;
+        std::size_t m_capacity;
+        std::string m_buffer;
+    };
+}
@@ -0,0 +1,478 @@
+#include "server.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "conversion.h"
+#include "error.h"
+#include "input.h"
+
+#if !defined(_WIN32)
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "algorithm.h"
+#include "batch.h"
+#include "profile.h"
+#include "result_cache.h"
+#include "result_writer.h"
+#include "solver.h"
+#include "thread_pool.h"
+#endif
+
+namespace kab_advent {
+#if !defined(_WIN32)
+    namespace {
+        using namespace std::literals;
+
+        struct request_header {
+            int day;
+            int part;
+            std::size_t input_size;
+        };
+
+        // Larger inputs are refused rather than buffered
+        constexpr auto max_input_size = std::int64_t{64} * 1024 * 1024;
+        constexpr auto max_header_size = std::size_t{64};
+        // A connection is closed when it sends nothing, or reads nothing of its answer, for this long
+        constexpr auto idle_timeout_seconds = 30;
+        // Every connection holds a thread, so further ones are refused until one of these ends
+        constexpr auto max_connections = std::size_t{256};
+
+        auto parse_request_header(std::string_view line) -> expected<request_header> {
+            auto const day_result = to_int(line);
+            if(!day_result) {
+                return make_unexpected(day_result.error());
+            }
+            line = line.substr(std::distance(line.data(), day_result.value().conversion_end));
+
+            auto const part_result = to_int(line);
+            if(!part_result) {
+                return make_unexpected(part_result.error());
+            }
+            line = line.substr(std::distance(line.data(), part_result.value().conversion_end));
+
+            auto const size_result = to_integer<std::int64_t>(line);
+            if(!size_result) {
+                return make_unexpected(size_result.error());
+            }
+            if(size_result.value().data < 0 || size_result.value().data > max_input_size) {
+                return make_unexpected(error_info(std::make_error_code(std::errc::file_too_large), "Input size must be between 0 and {} bytes").append(max_input_size));
+            }
+            if(!right_trim(line.substr(std::distance(line.data(), size_result.value().conversion_end))).empty()) {
+                return make_unexpected(error_info(std::make_error_code(std::errc::invalid_argument), "Expected \"<day> <part> <input size>\""));
+            }
+
+            return request_header{day_result.value().data, part_result.value().data, static_cast<std::size_t>(size_result.value().data)};
+        }
+
+        template<std::size_t N>
+        auto socket_error(char const (&message)[N], std::string_view subject = {}) -> error_info {
+            return error_info(std::error_code(errno, std::generic_category()), message, subject);
+        }
+
+        class socket_handle {
+        public:
+            explicit socket_handle(int fd) noexcept
+                : m_fd(fd) {
+            }
+            socket_handle(socket_handle const&) = delete;
+            auto operator=(socket_handle const&) -> socket_handle & = delete;
+            ~socket_handle() {
+                if(m_fd != -1) {
+                    ::close(m_fd);
+                }
+            }
+
+            auto get() const noexcept -> int { return m_fd; }
+
+        private:
+            int m_fd;
+        };
+
+        auto make_address(std::string_view path) -> expected<sockaddr_un> {
+            auto address = sockaddr_un();
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if(path.empty() || path.size() >= sizeof(address.sun_path)) {
+                return make_unexpected(error_info(std::make_error_code(std::errc::filename_too_long), "Socket path must hold 1 to {} characters")
+                    .append(sizeof(address.sun_path) - 1));
+            }
+            std::memcpy(address.sun_path, path.data(), path.size());
+            return address;
+        }
+
+        // Buffered reads and whole writes over a connected socket
+        class connection {
+        public:
+            explicit connection(int fd) noexcept
+                : m_fd(fd) {
+            }
+
+            // Reads the next line without its newline. Returns false at the end of the stream, on errors, and when
+            // no newline comes within max_size bytes
+            auto read_line(std::string & line, std::size_t const max_size) -> bool {
+                auto searched = std::size_t{0};
+                for(;;) {
+                    auto const pending = std::string_view(m_pending).substr(m_begin);
+                    auto const line_end = pending.find('\n', searched);
+                    if(line_end != std::string_view::npos) {
+                        line.assign(pending.substr(0, line_end));
+                        m_begin += line_end + 1;
+                        return true;
+                    }
+                    if(pending.size() > max_size) {
+                        return false;
+                    }
+                    searched = pending.size();
+                    if(!fill()) {
+                        return false;
+                    }
+                }
+            }
+
+            auto read_bytes(std::string & out, std::size_t const size) -> bool {
+                auto const pending = std::string_view(m_pending).substr(m_begin);
+                auto const buffered = std::min(pending.size(), size);
+                out.assign(pending.substr(0, buffered));
+                m_begin += buffered;
+
+                out.resize(size);
+                for(auto received = buffered; received < size;) {
+                    auto const count = ::read(m_fd, out.data() + received, size - received);
+                    if(count <= 0) {
+                        if(count < 0 && errno == EINTR) {
+                            continue;
+                        }
+                        return false;
+                    }
+                    received += static_cast<std::size_t>(count);
+                }
+                return true;
+            }
+
+            auto write_all(std::string_view bytes) -> bool {
+                while(!bytes.empty()) {
+                    auto const count = ::write(m_fd, bytes.data(), bytes.size());
+                    if(count < 0) {
+                        if(errno == EINTR) {
+                            continue;
+                        }
+                        return false;
+                    }
+                    bytes.remove_prefix(static_cast<std::size_t>(count));
+                }
+                return true;
+            }
+
+        private:
+            auto fill() -> bool {
+                constexpr auto chunk_size = std::size_t{64 * 1024};
+                m_pending.erase(0, m_begin);
+                m_begin = 0;
+
+                auto const old_size = m_pending.size();
+                m_pending.resize(old_size + chunk_size);
+                for(;;) {
+                    auto const count = ::read(m_fd, m_pending.data() + old_size, chunk_size);
+                    if(count < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    m_pending.resize(old_size + static_cast<std::size_t>(std::max<decltype(count)>(count, 0)));
+                    return count > 0;
+                }
+            }
+
+            int m_fd;
+            std::string m_pending;
+            std::size_t m_begin = 0;
+        };
+
+        auto format_answer(answer const& a) -> std::string {
+            auto response = "ok "s;
+            append_answer(response, a);
+            return response.append("\n");
+        }
+
+        auto format_error(error_info const& error) -> std::string {
+            auto o = std::ostringstream();
+            o << "error " << error << "\n";
+            return o.str();
+        }
+
+        auto answer_request(request_header const& header, std::string_view input) -> std::string {
+            auto const* const solver = find_solver(header.day, header.part);
+            if(solver == nullptr) {
+                return format_error(error_info(std::make_error_code(std::errc::invalid_argument), "Day {} is not implemented")
+                    .append(header.day).append(" part ").append(header.part));
+            }
+
+            auto const tag = profile::scoped_job(header.day, header.part);
+            try {
+                auto const result = result_cache::solve(*solver, input);
+                return result ? format_answer(result.value()) : format_error(result.error());
+            } catch(std::runtime_error const& e) {
+                return format_error(error_info(std::make_error_code(std::errc::invalid_argument), "{}", e.what()));
+            }
+        }
+
+        // Connections still being served, so that stopping the server can wake their blocked reads and wait for
+        // their threads to finish
+        class connection_registry {
+        public:
+            // Returns false when max_connections are already being served
+            auto add(int fd) -> bool {
+                auto const lock = std::lock_guard<std::mutex>(m_mutex);
+                if(m_fds.size() >= max_connections) {
+                    return false;
+                }
+                m_fds.push_back(fd);
+                return true;
+            }
+
+            // Called before the connection is closed, so that shutdown_all never touches a reused descriptor.
+            // The last thing a connection thread does with the registry
+            void remove(int fd) {
+                auto const lock = std::lock_guard<std::mutex>(m_mutex);
+                m_fds.erase(std::remove(m_fds.begin(), m_fds.end(), fd), m_fds.end());
+                if(m_fds.empty()) {
+                    m_all_removed.notify_all();
+                }
+            }
+
+            void shutdown_all() {
+                auto const lock = std::lock_guard<std::mutex>(m_mutex);
+                for(auto const fd : m_fds) {
+                    ::shutdown(fd, SHUT_RDWR);
+                }
+            }
+
+            void wait_until_empty() {
+                auto lock = std::unique_lock<std::mutex>(m_mutex);
+                m_all_removed.wait(lock, [this] { return m_fds.empty(); });
+            }
+
+        private:
+            std::mutex m_mutex;
+            std::condition_variable m_all_removed;
+            std::vector<int> m_fds;
+        };
+
+        void set_idle_timeout(int fd) {
+            auto timeout = timeval();
+            timeout.tv_sec = idle_timeout_seconds;
+            ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        }
+
+        // Runs on a thread of its own, so that waiting on a quiet client never holds a pool thread. Only solving a
+        // request goes through the pool
+        void serve_connection(int fd, thread_pool & pool, connection_registry & connections) {
+            auto const socket = socket_handle(fd);
+            try {
+                set_idle_timeout(fd);
+                auto c = connection(fd);
+                auto line = std::string();
+                auto input = std::string();
+                while(c.read_line(line, max_header_size)) {
+                    auto const header = parse_request_header(line);
+                    if(!header) {
+                        // Without a size the next request cannot be found, so the connection ends here
+                        c.write_all(format_error(header.error()));
+                        break;
+                    }
+                    if(!c.read_bytes(input, header.value().input_size)) {
+                        break;
+                    }
+                    auto const response = pool.submit([&header, &input] { return answer_request(header.value(), input); }).get();
+                    if(!c.write_all(response)) {
+                        break;
+                    }
+                }
+            } catch(std::exception const&) {
+                // Dropping the connection is all that is left to do with a request that could not be answered
+            }
+            connections.remove(fd);
+        }
+
+        volatile std::sig_atomic_t stop_requested = 0;
+
+        extern "C" void request_stop(int) {
+            stop_requested = 1;
+        }
+
+        void install_stop_handlers() {
+            struct sigaction action;
+            std::memset(&action, 0, sizeof(action));
+            action.sa_handler = request_stop;
+            sigemptyset(&action.sa_mask);
+            ::sigaction(SIGINT, &action, nullptr);
+            ::sigaction(SIGTERM, &action, nullptr);
+            // A client hanging up before reading its answer must not end the server
+            ::signal(SIGPIPE, SIG_IGN);
+        }
+
+        auto listen_on(std::string_view path) -> expected<int> {
+            auto const address = make_address(path);
+            if(!address) {
+                return make_unexpected(address.error());
+            }
+
+            // A socket left behind by a server that did not shut down cleanly is replaced, any other file is kept
+            struct stat existing;
+            if(::lstat(address.value().sun_path, &existing) == 0) {
+                if(!S_ISSOCK(existing.st_mode)) {
+                    return make_unexpected(error_info(std::make_error_code(std::errc::file_exists),
+                        "\"{}\" exists and is not a socket", path));
+                }
+                ::unlink(address.value().sun_path);
+            }
+
+            auto const fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if(fd == -1) {
+                return make_unexpected(socket_error("Could not create socket"));
+            }
+            if(::bind(fd, reinterpret_cast<sockaddr const*>(&address.value()), sizeof(sockaddr_un)) != 0
+               || ::listen(fd, SOMAXCONN) != 0) {
+                auto const error = socket_error("Could not listen on \"{}\"", path);
+                ::close(fd);
+                return make_unexpected(error);
+            }
+            return fd;
+        }
+    }
+
+    auto serve(gsl::span<std::string_view const> args) -> int {
+        if(args.size() < 1) {
+            throw std::runtime_error("Missing socket path after --serve");
+        }
+        auto const thread_count = parse_jobs_option(args.subspan(1));
+
+        auto const listener_fd = listen_on(args[0]);
+        if(!listener_fd) {
+            std::cerr << listener_fd.error() << "\n";
+            return EXIT_FAILURE;
+        }
+        auto const listener = socket_handle(listener_fd.value());
+        auto const socket_path = std::string(args[0]);
+
+        install_stop_handlers();
+        std::cerr << "Listening on " << socket_path << std::endl;
+
+        auto connections = connection_registry();
+        {
+            auto pool = thread_pool(thread_count);
+            while(!stop_requested) {
+                // Polls with a timeout so that a stop request arriving outside poll is still seen promptly
+                auto waiting = pollfd{listener.get(), POLLIN, 0};
+                if(::poll(&waiting, 1, 200) <= 0) {
+                    continue;
+                }
+
+                auto const fd = ::accept(listener.get(), nullptr, nullptr);
+                if(fd == -1) {
+                    continue;
+                }
+                if(!connections.add(fd)) {
+                    connection(fd).write_all(format_error(error_info(std::make_error_code(std::errc::too_many_files_open), "Too many connections")));
+                    ::close(fd);
+                    continue;
+                }
+                try {
+                    std::thread([fd, &pool, &connections] { serve_connection(fd, pool, connections); }).detach();
+                } catch(std::system_error const&) {
+                    connections.remove(fd);
+                    ::close(fd);
+                }
+            }
+            connections.shutdown_all();
+            connections.wait_until_empty();
+        }
+
+        ::unlink(socket_path.c_str());
+        return EXIT_SUCCESS;
+    }
+
+    auto client(gsl::span<std::string_view const> args) -> int {
+        if(args.size() < 1) {
+            throw std::runtime_error("Missing socket path after --client");
+        }
+        if(args.size() < 3) {
+            throw std::runtime_error("Missing day and part after the socket path");
+        }
+        auto const day_result = to_int(args[1]);
+        auto const part_result = to_int(args[2]);
+        if(!day_result || !part_result) {
+            throw std::runtime_error("Day and part must be integers");
+        }
+
+        auto const buffer = read_input(args.subspan(3));
+        if(!buffer) {
+            std::cerr << buffer.error() << "\n";
+            return EXIT_FAILURE;
+        }
+
+        auto const address = make_address(args[0]);
+        if(!address) {
+            std::cerr << address.error() << "\n";
+            return EXIT_FAILURE;
+        }
+        auto const socket = socket_handle(::socket(AF_UNIX, SOCK_STREAM, 0));
+        if(socket.get() == -1 || ::connect(socket.get(), reinterpret_cast<sockaddr const*>(&address.value()), sizeof(sockaddr_un)) != 0) {
+            std::cerr << socket_error("Could not connect to \"{}\"", args[0]) << "\n";
+            return EXIT_FAILURE;
+        }
+
+        ::signal(SIGPIPE, SIG_IGN);
+        auto c = connection(socket.get());
+        auto const request = std::to_string(day_result.value().data).append(" ")
+            .append(std::to_string(part_result.value().data)).append(" ")
+            .append(std::to_string(buffer.value().size())).append("\n");
+        auto response = std::string();
+        if(!c.write_all(request) || !c.write_all(buffer.value().view()) || !c.read_line(response, static_cast<std::size_t>(max_input_size))) {
+            std::cerr << error_info(std::make_error_code(std::errc::connection_aborted), "The server closed the connection") << "\n";
+            return EXIT_FAILURE;
+        }
+
+        if(begins_with(response, "ok ")) {
+            std::cout << std::string_view(response).substr(3) << "\n";
+            return EXIT_SUCCESS;
+        }
+        std::cerr << (begins_with(response, "error ") ? std::string_view(response).substr(6) : std::string_view(response)) << "\n";
+        return EXIT_FAILURE;
+    }
+#else
+    namespace {
+        auto unsupported() -> int {
+            std::cerr << error_info(std::make_error_code(std::errc::function_not_supported), "Unix domain sockets are not supported on this platform") << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    auto serve(gsl::span<std::string_view const>) -> int {
+        return unsupported();
+    }
+
+    auto client(gsl::span<std::string_view const>) -> int {
+        return unsupported();
+    }
+#endif
+}
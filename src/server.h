@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string_view>
+#include <gsl/span>
+
+namespace kab_advent {
+    // Keeps the process resident and answers requests on the Unix domain socket named by args[0], until interrupted.
+    // A connection carries any number of requests, each a "<day> <part> <input size>\n" line followed by the input
+    // bytes, and gets one "ok <answer>\n" or "error <message>\n" line back per request. Each connection is read on a
+    // thread of its own and closed after 30 s without progress. Requests are solved on a thread pool ("--jobs <n>"
+    // threads, all hardware threads by default) and answers go through the result and parse caches, so both stay
+    // warm between requests
+    auto serve(gsl::span<std::string_view const> args) -> int;
+
+    // Sends one request to a server. args are the socket path, the day, the part and then the input arguments of a
+    // day run. Prints the answer like a day run does
+    auto client(gsl::span<std::string_view const> args) -> int;
+}
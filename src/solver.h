@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <gsl/span>
+
+#include "error.h"
+#include "parse_cache.h"
+#include "profile.h"
+
+namespace kab_advent {
+    using answer = std::variant<std::int64_t, std::string>;
+
+    template<typename T>
+    auto make_answer(T&& value) -> answer {
+        if constexpr(std::is_integral<std::decay_t<T>>::value) {
+            return static_cast<std::int64_t>(value);
+        } else {
+            return std::string(std::forward<T>(value));
+        }
+    }
+
+    inline auto operator<<(std::ostream& o, answer const& a) -> std::ostream& {
+        std::visit([&o] (auto const& value) { o << value; }, a);
+        return o;
+    }
+
+    // Parsed input of a day, shared by both of its parts. Views in the parsed input may refer to the text it was parsed from
+    using parsed_input = std::shared_ptr<void const>;
+
+    enum class input_kind {
+        line,   // The whole input is a single line
+        lines,  // One record per line
+    };
+
+    struct solver {
+        int day;
+        int part;
+        input_kind kind;
+        bool supports_stdin;
+        bool supports_inline;
+        auto (*parse)(std::string_view input) -> expected<parsed_input>;
+        // Parses a stream line by line as it arrives, without holding all of it. Null for days that parse text only
+        auto (*parse_stream)(std::istream & stream) -> expected<parsed_input>;
+        auto (*solve)(parsed_input const& input) -> answer;
+        // Serialization of the parsed input for the parse cache, both null for days whose input is not cached
+        void (*save)(parsed_input const& input, std::string & out);
+        auto (*load)(std::string_view bytes) -> expected<parsed_input>;
+    };
+
+    // Every implemented solver, ordered by day then part
+    auto solvers() noexcept -> gsl::span<solver const>;
+    // Returns nullptr if the day or part is not implemented
+    auto find_solver(int day, int part) noexcept -> solver const*;
+
+    // What one run of a solver cost, reported by --format metrics. Phases are only measured while profiling is
+    // enabled. Heap figures cover the thread that ran the phase and the helpers parsing chunks of its input
+    struct solve_stats {
+        profile::phase_sample parse;
+        profile::phase_sample solve;
+        std::size_t input_bytes = 0;
+        // Answered by the result cache, without parsing or solving
+        bool cached = false;
+
+        // The parsed input is still alive while the part is solved
+        auto peak_bytes() const noexcept -> std::int64_t {
+            return std::max(parse.peak_bytes, parse.retained_bytes + solve.peak_bytes);
+        }
+    };
+
+    inline auto run_solver(solver const& s, std::string_view input, solve_stats * stats = nullptr) -> expected<answer> {
+        if(stats != nullptr) {
+            stats->input_bytes = input.size();
+        }
+        auto const parsed = [&s, input, stats] {
+            auto const scope = profile::scoped_phase(profile::phase::parse, stats != nullptr ? &stats->parse : nullptr);
+            return parse_cache::parse(s, input);
+        }();
+        if(!parsed) {
+            return make_unexpected(parsed.error());
+        }
+
+        auto const scope = profile::scoped_phase(profile::phase::solve, stats != nullptr ? &stats->solve : nullptr);
+        return s.solve(parsed.value());
+    }
+
+    // Streamed inputs bypass the parse and result caches, which are keyed by the whole text. The parse phase includes
+    // the time spent waiting for the stream. The size of a streamed input is not known, and left at 0 in stats
+    inline auto run_stream_solver(solver const& s, std::istream & stream, solve_stats * stats = nullptr) -> expected<answer> {
+        auto const parsed = [&s, &stream, stats] {
+            auto const scope = profile::scoped_phase(profile::phase::parse, stats != nullptr ? &stats->parse : nullptr);
+            return s.parse_stream(stream);
+        }();
+        if(!parsed) {
+            return make_unexpected(parsed.error());
+        }
+
+        auto const scope = profile::scoped_phase(profile::phase::solve, stats != nullptr ? &stats->solve : nullptr);
+        return s.solve(parsed.value());
+    }
+}
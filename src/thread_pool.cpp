@@ -0,0 +1,103 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace kab_advent {
+    namespace {
+        struct worker_identity {
+            thread_pool const* pool;
+            std::size_t index;
+        };
+
+        thread_local worker_identity current_worker = {nullptr, 0};
+    }
+
+    thread_pool::thread_pool(std::size_t thread_count) {
+        thread_count = std::max<std::size_t>(thread_count, 1);
+        m_queues.reserve(thread_count);
+        for(std::size_t i = 0; i < thread_count; ++i) {
+            m_queues.push_back(std::make_unique<task_queue>());
+        }
+
+        m_threads.reserve(thread_count);
+        for(std::size_t i = 0; i < thread_count; ++i) {
+            m_threads.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    thread_pool::~thread_pool() {
+        {
+            auto const lock = std::lock_guard<std::mutex>(m_wake_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for(auto & thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    auto thread_pool::default_thread_count() noexcept -> std::size_t {
+        return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    void thread_pool::push(task t) {
+        // Workers keep the tasks they spawn, so nested work stays hot in their cache until someone steals it
+        auto const index = current_worker.pool == this
+            ? current_worker.index
+            : m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+        {
+            auto & queue = *m_queues[index];
+            auto const lock = std::lock_guard<std::mutex>(queue.mutex);
+            queue.tasks.push_back(std::move(t));
+        }
+        {
+            auto const lock = std::lock_guard<std::mutex>(m_wake_mutex);
+            m_pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_wake.notify_one();
+    }
+
+    auto thread_pool::try_pop(std::size_t index, task & t) -> bool {
+        auto & queue = *m_queues[index];
+        auto const lock = std::lock_guard<std::mutex>(queue.mutex);
+        if(queue.tasks.empty()) {
+            return false;
+        }
+        t = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    auto thread_pool::try_steal(std::size_t index, task & t) -> bool {
+        for(std::size_t offset = 1; offset < m_queues.size(); ++offset) {
+            auto & queue = *m_queues[(index + offset) % m_queues.size()];
+            auto const lock = std::unique_lock<std::mutex>(queue.mutex, std::try_to_lock);
+            if(!lock || queue.tasks.empty()) {
+                continue;
+            }
+            t = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void thread_pool::work(std::size_t index) {
+        current_worker = {this, index};
+        auto t = task();
+        while(true) {
+            if(try_pop(index, t) || try_steal(index, t)) {
+                m_pending.fetch_sub(1, std::memory_order_relaxed);
+                t();
+                t = nullptr;
+                continue;
+            }
+
+            auto lock = std::unique_lock<std::mutex>(m_wake_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || m_pending.load(std::memory_order_relaxed) != 0; });
+            if(m_stopping && m_pending.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+        }
+    }
+}
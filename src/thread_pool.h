@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace kab_advent {
+    // Work-stealing pool: every worker owns a task queue, runs its own tasks newest first and steals the oldest
+    // tasks of other workers when it runs out. Tasks submitted from outside the pool are dealt round-robin
+    class thread_pool {
+    public:
+        explicit thread_pool(std::size_t thread_count = default_thread_count());
+        thread_pool(thread_pool const&) = delete;
+        auto operator=(thread_pool const&) -> thread_pool & = delete;
+        ~thread_pool();
+
+        template<typename F>
+        auto submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+            using result_t = std::invoke_result_t<std::decay_t<F>>;
+            auto task = std::make_shared<std::packaged_task<result_t()>>(std::forward<F>(f));
+            auto result = task->get_future();
+            push([task] { (*task)(); });
+            return result;
+        }
+
+        auto thread_count() const noexcept -> std::size_t { return m_threads.size(); }
+
+        static auto default_thread_count() noexcept -> std::size_t;
+
+    private:
+        using task = std::function<void()>;
+
+        struct task_queue {
+            std::mutex mutex;
+            std::deque<task> tasks;
+        };
+
+        void push(task t);
+        auto try_pop(std::size_t index, task & t) -> bool;
+        auto try_steal(std::size_t index, task & t) -> bool;
+        void work(std::size_t index);
+
+        std::vector<std::unique_ptr<task_queue>> m_queues;
+        std::vector<std::thread> m_threads;
+        std::atomic<std::size_t> m_next_queue{0};
+        std::atomic<std::size_t> m_pending{0};
+        std::mutex m_wake_mutex;
+        std::condition_variable m_wake;
+        bool m_stopping = false;
+    };
+}